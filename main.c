@@ -1,581 +1,7770 @@
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <string>
-#include <windows.h>
-#include <conio.h>
-#include <ctime>
-#include <cstdlib>
-#include <limits>
-
-// --- Struct Definitions ---
-// NOTE: Replaced C-style char arrays with std::string for safety and convenience.
-struct Car {
-    std::string plate_num;
-    std::string brand;
-    std::string model;
-    float capacity;
-    std::string colour;
-    float rate_per_hour;
-    float rate_per_half;
-    float rate_per_day;
-    std::string transmission;
-};
-
-struct Customer {
-    int id;
-    std::string name;
-    std::string phone;
-    std::string ic;
-    std::string address;
-};
-
-struct UserPassword {
-    int id;
-    std::string password;
-};
-
-
-// --- Utility Functions ---
-
-// Sets cursor position in the console (Windows specific)
-void gotoxy(int x, int y) {
-    COORD coord;
-    coord.X = x;
-    coord.Y = y;
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
-}
-
-// Clears the console screen
-void clear_screen() {
-    system("cls");
-}
-
-// Pauses execution until a key is pressed
-void press_any_key_to_continue() {
-    std::cout << "\n\n\t | \t\t\tPress any key to continue...";
-    _getch();
-}
-
-// Gets the current date and time as a string
-std::string current_date_time() {
-    time_t now = time(0);
-    struct tm tstruct;
-    char buf[80];
-    localtime_s(&tstruct, &now);
-    strftime(buf, sizeof(buf), "%d/%m/%Y TIME: %X", &tstruct);
-    return buf;
-}
-
-// Displays a border on the screen
-void draw_border() {
-    clear_screen();
-    for (int i = 10; i < 140; i++) {
-        gotoxy(i, 10); std::cout << "=";
-        gotoxy(i, 58); std::cout << "=";
-    }
-    for (int i = 10; i < 58; i++) {
-        gotoxy(10, i); std::cout << "|";
-        gotoxy(140, i); std::cout << "|";
-    }
-}
-
-// Displays a loading animation
-void display_loading_bar(const std::string& message) {
-    draw_border();
-    int timer = 5 + rand() % 15;
-    gotoxy(65, 34);
-    std::cout << message;
-    gotoxy(60, 36);
-    for (int r = 1; r <= timer; r++) {
-        for (long long q = 0; q <= 10000000; q++); // Slow down
-        std::cout << (char)177;
-    }
-    Sleep(100);
-    clear_screen();
-}
-
-// Displays ASCII art from a file
-void display_art(const std::string& filename) {
-    draw_border();
-    gotoxy(0, 20);
-
-    std::ifstream ifs(filename);
-    if (ifs) {
-        std::string line;
-        while (std::getline(ifs, line)) {
-            std::cout << line << std::endl;
-        }
-        gotoxy(20, 15);
-        std::cout << "\t\t\t\tDATE: " << current_date_time() << std::endl;
-    }
-    ifs.close();
-}
-
-
-// --- Main Application Class ---
-
-class RentalSystem {
-private:
-    std::vector<Car> all_cars;
-    std::vector<Car> available_cars;
-    std::vector<Customer> customers;
-    std::vector<UserPassword> users;
-
-    // --- Private Helper Methods ---
-
-    // Safely reads an integer from input
-    int get_numeric_input() {
-        int choice;
-        while (!(std::cin >> choice)) {
-            std::cout << "\n\t | \t\tInvalid input. Please enter a number: ";
-            std::cin.clear();
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        }
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Consume newline
-        return choice;
-    }
-
-    // Securely reads a password from input
-    std::string get_password_input() {
-        std::string password;
-        char ch;
-        ch = _getch();
-        while (ch != 13) { // 13 is the ASCII for Enter
-            if (ch == '\b') { // Backspace
-                if (!password.empty()) {
-                    password.pop_back();
-                    std::cout << "\b \b";
-                }
-            } else {
-                password.push_back(ch);
-                std::cout << '*';
-            }
-            ch = _getch();
-        }
-        std::cout << std::endl;
-        return password;
-    }
-    
-    // Calculates rental price
-    int calculate_rate(int hours, const Car& car) {
-        int days = hours / 24;
-        int half_days = (hours % 24) / 12;
-        int remaining_hours = (hours % 24) % 12;
-        return (days * car.rate_per_day) + (half_days * car.rate_per_half) + (remaining_hours * car.rate_per_hour);
-    }
-    
-    // Displays a list of cars
-    void display_car_list(const std::vector<Car>& car_list) {
-        std::cout << "\t  |  Plate Number\tBrand\t Model\t\tCapacity   Colour\t Rate/Hr   Rate/12Hr   Rate/24Hr   Transmission" << std::endl;
-        std::cout << "\t  |  ======================================================================================================================================" << std::endl;
-        for (const auto& car : car_list) {
-            printf("\t  |  %-15s\t%-8s\t %-15s %-10.1f %-10s\t %-10.2f %-10.2f %-10.2f %-10s\n",
-                   car.plate_num.c_str(), car.brand.c_str(), car.model.c_str(), car.capacity,
-                   car.colour.c_str(), car.rate_per_hour, car.rate_per_half, car.rate_per_day,
-                   car.transmission.c_str());
-        }
-    }
-
-
-public:
-    RentalSystem() {
-        // Seed random number generator
-        srand(time(0));
-    }
-
-    // --- Data Loading and Saving ---
-
-    void load_all_data() {
-        load_cars();
-        load_available_cars();
-        load_customers();
-        load_users();
-    }
-
-    void load_cars() {
-        std::ifstream file("car rental.txt");
-        all_cars.clear();
-        Car temp_car;
-        while (file >> temp_car.plate_num >> temp_car.brand >> temp_car.model >> temp_car.capacity >> temp_car.colour >> temp_car.rate_per_hour >> temp_car.rate_per_half >> temp_car.rate_per_day >> temp_car.transmission) {
-            all_cars.push_back(temp_car);
-        }
-        file.close();
-    }
-    
-    void load_available_cars() {
-        std::ifstream file("available.txt");
-        available_cars.clear();
-        Car temp_car;
-        while (file >> temp_car.plate_num >> temp_car.brand >> temp_car.model >> temp_car.capacity >> temp_car.colour >> temp_car.rate_per_hour >> temp_car.rate_per_half >> temp_car.rate_per_day >> temp_car.transmission) {
-            available_cars.push_back(temp_car);
-        }
-        file.close();
-    }
-    
-    void load_customers() {
-        std::ifstream file("Customer.txt");
-        customers.clear();
-        Customer temp_cust;
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
-            size_t pos1 = line.find(';');
-            size_t pos2 = line.find(';', pos1 + 1);
-            size_t pos3 = line.find(';', pos2 + 1);
-            size_t pos4 = line.find(';', pos3 + 1);
-            
-            temp_cust.id = std::stoi(line.substr(0, pos1));
-            temp_cust.name = line.substr(pos1 + 1, pos2 - pos1 - 1);
-            temp_cust.phone = line.substr(pos2 + 1, pos3 - pos2 - 1);
-            temp_cust.ic = line.substr(pos3 + 1, pos4 - pos3 - 1);
-            temp_cust.address = line.substr(pos4 + 1);
-            customers.push_back(temp_cust);
-        }
-        file.close();
-    }
-
-    void load_users() {
-        std::ifstream file("UserPass.txt");
-        users.clear();
-        UserPassword temp_user;
-        while(file >> temp_user.id >> temp_user.password) {
-            users.push_back(temp_user);
-        }
-        file.close();
-    }
-    
-    void save_data_to_file(const std::string& filename, const std::vector<Car>& car_list) {
-        std::ofstream file(filename);
-        for(size_t i = 0; i < car_list.size(); ++i) {
-            file << car_list[i].plate_num << " " << car_list[i].brand << " " << car_list[i].model << " "
-                 << car_list[i].capacity << " " << car_list[i].colour << " " << car_list[i].rate_per_hour << " "
-                 << car_list[i].rate_per_half << " " << car_list[i].rate_per_day << " " << car_list[i].transmission
-                 << (i == car_list.size() - 1 ? "" : "\n");
-        }
-        file.close();
-    }
-    
-    // --- Menus ---
-
-    void main_menu() {
-        int choice;
-        do {
-            display_art("art.txt");
-            std::cout << "\n\n\t |\t\t\t\t\t\t\t  1. ADMIN";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  2. USER";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  3. TERMS & CONDITIONS";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  4. EXIT" << std::endl;
-            std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
-            choice = get_numeric_input();
-            clear_screen();
-
-            switch (choice) {
-                case 1: admin_login(); break;
-                case 2: user_menu(); break;
-                case 3: show_terms_and_conditions(); break;
-                case 4: 
-                    display_art("exit art.txt");
-                    Sleep(2000);
-                    break;
-                default:
-                    std::cout << "\n\t | \t\tInvalid choice. Please try again.";
-                    press_any_key_to_continue();
-            }
-        } while (choice != 4);
-    }
-    
-    void admin_login() {
-        draw_border();
-        gotoxy(40, 20);
-        std::cout << "\n\n\n\n\t | \t\t\tEnter Password: ";
-        std::string password = get_password_input();
-
-        bool logged_in = false;
-        if (password == "a") { // Default/master password
-            logged_in = true;
-        } else {
-            for(const auto& user : users) {
-                if (user.password == password) {
-                    logged_in = true;
-                    break;
-                }
-            }
-        }
-        
-        if (logged_in) {
-            display_loading_bar("LOGGING IN...");
-            admin_menu();
-        } else {
-            std::cout << "\n\t | \t\t\tWrong Password... Returning to Main Menu.";
-            Sleep(2000);
-            clear_screen();
-        }
-    }
-    
-    void admin_menu() {
-         int choice;
-        do {
-            display_art("art.txt");
-            std::cout << "\n\t |\t\t\t\t\t\t\t  1. ADD NEW ADMIN";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  2. SHOW ALL CAR DATA";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  3. ADD NEW CAR";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  4. DELETE CAR";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  5. RESET AVAILABLE CARS";
-            std::cout << "\n\t |\t\t\t\t\t\t\t  6. LOG OFF" << std::endl;
-            std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
-            choice = get_numeric_input();
-
-            clear_screen();
-            switch(choice) {
-                case 1: add_new_user(); break;
-                case 2: show_all_car_data(); break;
-                case 3: add_new_car(); break;
-                case 4: delete_car(); break;
-                case 5: reset_available_cars(); break;
-                case 6: display_loading_bar("LOGGING OFF..."); break;
-                default: std::cout << "\n\t | \t\tInvalid choice."; press_any_key_to_continue();
-            }
-        } while(choice != 6);
-    }
-    
-    void user_menu() {
-        int choice;
-        display_art("art.txt");
-        std::cout << "\n\t |\t\t\t\t\t\t\t  1. NEW CUSTOMER";
-        std::cout << "\n\t |\t\t\t\t\t\t\t  2. EXISTING CUSTOMER";
-        std::cout << "\n\t |\t\t\t\t\t\t\t  3. MAIN MENU" << std::endl;
-        std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
-        choice = get_numeric_input();
-        clear_screen();
-        
-        switch(choice) {
-            case 1: new_customer_rental(); break;
-            case 2: existing_customer_rental(); break;
-            case 3: break;
-            default: std::cout << "\n\t | \t\tInvalid choice."; press_any_key_to_continue();
-        }
-    }
-
-    // --- Admin Functions ---
-    void add_new_user() {
-        draw_border();
-        gotoxy(40, 20);
-        UserPassword new_user;
-        new_user.id = users.empty() ? 1 : users.back().id + 1;
-        
-        std::cout << "\n\n\n\n\t | \t\t\tNew Admin ID (Default): " << new_user.id;
-        std::cout << "\n\t | \t\t\tEnter New Password: ";
-        new_user.password = get_password_input();
-        users.push_back(new_user);
-
-        std::ofstream ofs("UserPass.txt", std::ios::app);
-        ofs << "\n" << new_user.id << " " << new_user.password;
-        ofs.close();
-        
-        std::cout << "\n\t | \t\t\tNew admin added successfully!";
-        press_any_key_to_continue();
-    }
-    
-    void show_all_car_data() {
-        display_art("art.txt");
-        display_car_list(all_cars);
-        press_any_key_to_continue();
-    }
-
-    void add_new_car() {
-        display_art("art.txt");
-        Car new_car;
-        std::cout << "\n\t | \t\tPlease enter the car data below:" << std::endl;
-        std::cout << "\n\t | \t\tPlate Number: "; std::getline(std::cin, new_car.plate_num);
-        std::cout << "\t | \t\tBrand: "; std::getline(std::cin, new_car.brand);
-        std::cout << "\t | \t\tModel: "; std::getline(std::cin, new_car.model);
-        std::cout << "\t | \t\tCapacity: "; std::cin >> new_car.capacity; std::cin.ignore();
-        std::cout << "\t | \t\tColour: "; std::getline(std::cin, new_car.colour);
-        std::cout << "\t | \t\tRate Per Hour: "; std::cin >> new_car.rate_per_hour; std::cin.ignore();
-        std::cout << "\t | \t\tRate Per 12 Hours: "; std::cin >> new_car.rate_per_half; std::cin.ignore();
-        std::cout << "\t | \t\tRate Per 24 Hours: "; std::cin >> new_car.rate_per_day; std::cin.ignore();
-        std::cout << "\t | \t\tTransmission (A/M): "; std::getline(std::cin, new_car.transmission);
-
-        all_cars.push_back(new_car);
-        save_data_to_file("car rental.txt", all_cars);
-        
-        std::cout << "\n\t | \t\tCar added successfully!";
-        press_any_key_to_continue();
-        load_cars(); // Refresh data
-    }
-
-    void delete_car() {
-        display_art("art.txt");
-        display_car_list(all_cars);
-        std::string plate_to_delete;
-        std::cout << "\n\n\t | \t\tEnter the plate number of the car to delete: ";
-        std::getline(std::cin, plate_to_delete);
-        
-        std::vector<Car> updated_cars;
-        bool found = false;
-        for(const auto& car : all_cars) {
-            if (car.plate_num != plate_to_delete) {
-                updated_cars.push_back(car);
-            } else {
-                found = true;
-            }
-        }
-        
-        if (found) {
-            all_cars = updated_cars;
-            save_data_to_file("car rental.txt", all_cars);
-            std::cout << "\n\t | \t\tCar deleted successfully!";
-        } else {
-            std::cout << "\n\t | \t\tCar not found.";
-        }
-        press_any_key_to_continue();
-        load_cars(); // Refresh data
-    }
-    
-    void reset_available_cars() {
-        available_cars = all_cars;
-        save_data_to_file("available.txt", available_cars);
-        display_loading_bar("UPDATING DATABASE...");
-        std::cout << "\n\t | \t\tAvailable car list has been reset to full stock.";
-        press_any_key_to_continue();
-    }
-    
-    // --- User Functions ---
-    void new_customer_rental() {
-        display_art("art.txt");
-        Customer new_cust;
-        new_cust.id = customers.empty() ? 1001 : customers.back().id + 1;
-
-        std::cout << "\n\t | \t\tPlease enter your details:" << std::endl;
-        std::cout << "\n\t | \t\tYour Customer ID will be: " << new_cust.id << std::endl;
-        std::cout << "\t | \t\tName: "; std::getline(std::cin, new_cust.name);
-        std::cout << "\t | \t\tPhone Number: "; std::getline(std::cin, new_cust.phone);
-        std::cout << "\t | \t\tIC: "; std::getline(std::cin, new_cust.ic);
-        std::cout << "\t | \t\tAddress: "; std::getline(std::cin, new_cust.address);
-        
-        customers.push_back(new_cust);
-
-        std::ofstream ofs("Customer.txt", std::ios::app);
-        ofs << (customers.size() == 1 ? "" : "\n") << new_cust.id << ";" << new_cust.name << ";" << new_cust.phone << ";" << new_cust.ic << ";" << new_cust.address;
-        ofs.close();
-        
-        std::cout << "\n\t | \t\tCustomer added successfully!";
-        press_any_key_to_continue();
-        
-        // Proceed to rental process
-        rent_a_car(new_cust);
-    }
-    
-    void existing_customer_rental() {
-        display_art("art.txt");
-        std::cout << "\n\t | \t\tPlease enter your Customer ID: ";
-        int user_id = get_numeric_input();
-        
-        bool found = false;
-        for(const auto& cust : customers) {
-            if (cust.id == user_id) {
-                std::cout << "\n\t | \t\tWelcome back, " << cust.name << "!";
-                press_any_key_to_continue();
-                rent_a_car(cust);
-                found = true;
-                break;
-            }
-        }
-        
-        if (!found) {
-            std::cout << "\n\t | \t\tCustomer ID not found.";
-            press_any_key_to_continue();
-        }
-    }
-
-    void rent_a_car(const Customer& cust) {
-        clear_screen();
-        display_art("art.txt");
-        std::cout << "\n\t | \t\tAvailable Cars for Rent:" << std::endl;
-        display_car_list(available_cars);
-        
-        std::string plate_to_rent;
-        std::cout << "\n\n\t | \t\tEnter the plate number of the car you want to rent: ";
-        std::getline(std::cin, plate_to_rent);
-
-        Car selected_car;
-        bool car_found = false;
-        std::vector<Car> updated_available_cars;
-
-        for (const auto& car : available_cars) {
-            if (car.plate_num == plate_to_rent) {
-                selected_car = car;
-                car_found = true;
-            } else {
-                updated_available_cars.push_back(car);
-            }
-        }
-
-        if (!car_found) {
-            std::cout << "\n\t | \t\tInvalid plate number or car is not available.";
-            press_any_key_to_continue();
-            return;
-        }
-
-        std::cout << "\t | \t\tEnter hours of rent: ";
-        int hours = get_numeric_input();
-        
-        int total_cost = calculate_rate(hours, selected_car);
-        std::cout << "\n\t | \t\tTotal rental price for " << hours << " hours is: RM " << total_cost;
-
-        // Update available cars file
-        available_cars = updated_available_cars;
-        save_data_to_file("available.txt", available_cars);
-
-        // Log the transaction
-        std::ofstream log("Log.txt", std::ios::app);
-        log << "\n==========================================================";
-        log << "\nDATE: " << current_date_time();
-        log << "\nCUSTOMER: " << cust.name << " (ID: " << cust.id << ")";
-        log << "\nCAR: " << selected_car.plate_num << " (" << selected_car.brand << " " << selected_car.model << ")";
-        log << "\nHOURS: " << hours;
-        log << "\nPAYMENT: RM " << total_cost;
-        log.close();
-
-        press_any_key_to_continue();
-    }
-
-
-    // --- Other Functions ---
-    void show_terms_and_conditions() {
-        display_art("art.txt");
-        std::cout << "\n\t |\t\t\t1. MINIMUM RENT TIME IS 3 HOURS";
-        std::cout << "\n\t |\t\t\t2. RENT AT YOUR OWN RISK";
-        std::cout << "\n\t |\t\t\t3. IN CASE OF AN ACCIDENT, ALL COSTS ARE BORNE BY THE DRIVER";
-        std::cout << "\n\t |\t\t\t4. PLEASE PREPARE THE FOLLOWING ITEMS:";
-        std::cout << "\n\t |\t\t\t     - COPY OF IC, LICENSE";
-        std::cout << "\n\t |\t\t\t     - DEPOSIT (BASED ON CAR TYPE)";
-        std::cout << "\n\t |\t\t\t5. ADDITIONAL CHARGES WILL APPLY FOR LATE RETURNS";
-        std::cout << "\n\t |\t\t\t6. DRIVE SAFELY!";
-        press_any_key_to_continue();
-    }
-    
-    void run() {
-        display_art("welcome.txt");
-        Sleep(1000);
-        display_loading_bar("BOOTING UP...");
-        load_all_data();
-        main_menu();
-    }
-};
-
-
-int main() {
-    // This Windows-specific function can be used to attempt to set fullscreen.
-    // May not work on all systems.
-    // keybd_event(VK_MENU, 0x38, 0, 0);
-    // keybd_event(VK_RETURN, 0x1c, 0, 0);
-    // keybd_event(VK_RETURN, 0x1c, KEYEVENTF_KEYUP, 0);
-    // keybd_event(VK_MENU, 0x38, KEYEVENTF_KEYUP, 0);
-
-    RentalSystem app;
-    app.run();
-
-    return 0;
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <ctime>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <set>
+#include <iterator>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#include <charconv>
+#include <thread>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <queue>
+#include <list>
+#include <functional>
+#include <cctype>
+#include <cerrno>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAVE_SSE2 1
+#endif
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <conio.h>
+#include <io.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// --- Struct Definitions ---
+// NOTE: Replaced C-style char arrays with std::string for safety and convenience.
+struct Car {
+    std::string plate_num;
+    std::string brand;
+    std::string model;
+    float capacity;
+    std::string colour;
+    float rate_per_hour;
+    float rate_per_half;
+    float rate_per_day;
+    std::string transmission;
+};
+
+struct Customer {
+    int id;
+    std::string name;
+    std::string phone;
+    std::string ic;
+    std::string address;
+};
+
+// Outcome of a non-interactive rental operation
+enum class OpStatus {
+    OK,
+    NOT_FOUND,       // No such plate or customer
+    NOT_AVAILABLE,   // Car is already rented out
+    DUPLICATE,       // Plate already in the fleet
+    INVALID,         // Bad argument, e.g. non-positive hours
+    BOOKED           // Car still has bookings to honour
+};
+
+const char* op_status_name(OpStatus status) {
+    switch (status) {
+        case OpStatus::OK: return "OK";
+        case OpStatus::NOT_FOUND: return "NOT_FOUND";
+        case OpStatus::NOT_AVAILABLE: return "NOT_AVAILABLE";
+        case OpStatus::DUPLICATE: return "DUPLICATE";
+        case OpStatus::INVALID: return "INVALID";
+        case OpStatus::BOOKED: return "BOOKED";
+    }
+    return "UNKNOWN";
+}
+
+struct UserPassword {
+    int id;
+    std::string password;
+};
+
+
+// --- Metrics ---
+
+// Timed spots on the hot paths. METRIC_NAMES gives each its name in reports.
+enum class Metric {
+    LOAD_SNAPSHOT,
+    LOAD_CAR_FILE,
+    LOAD_AVAILABLE_FILE,
+    LOAD_CUSTOMER_FILE,
+    LOAD_USER_FILE,
+    REPLAY_JOURNAL,
+    SAVE_FILE,
+    SAVE_SNAPSHOT,
+    RENT_LOOKUP,
+    RENT_PRICING,
+    RENT_PERSIST,
+    RENT_LOG,
+    RENT_TOTAL,
+    ALLOCATE_PLAN,
+    ALLOCATE_COMMIT,
+    CUSTOMER_LOOKUP,
+    ADMIN_LOGIN,
+    UI_RENDER,
+    COUNT
+};
+const size_t METRIC_COUNT = static_cast<size_t>(Metric::COUNT);
+const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "load.snapshot", "load.car_file", "load.available_file", "load.customer_file", "load.user_file", "load.journal",
+    "save.file", "save.snapshot", "rent.lookup", "rent.pricing", "rent.persist", "rent.log", "rent.total",
+    "allocate.plan", "allocate.commit", "customer.lookup", "admin.login", "ui.render"};
+
+int highest_bit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(bits);
+#endif
+}
+
+// Latency histogram with four buckets per power of two, so a percentile is
+// within 25% of the true value. Values are nanoseconds.
+struct Histogram {
+    static const int SUB_BITS = 2;
+    static const size_t BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t buckets[BUCKETS] = {};
+
+    static size_t bucket_of(uint64_t ns) {
+        if (ns < (1u << SUB_BITS)) return static_cast<size_t>(ns);
+        int exponent = highest_bit(ns);
+        size_t sub = static_cast<size_t>(ns >> (exponent - SUB_BITS)) & ((1u << SUB_BITS) - 1);
+        return (static_cast<size_t>(exponent - SUB_BITS + 1) << SUB_BITS) + sub;
+    }
+
+    // Largest value that falls in the bucket
+    static uint64_t bucket_limit(size_t bucket) {
+        if (bucket < (1u << SUB_BITS)) return bucket;
+        int exponent = static_cast<int>(bucket >> SUB_BITS) + SUB_BITS - 1;
+        uint64_t sub = bucket & ((1u << SUB_BITS) - 1);
+        uint64_t low = (uint64_t(1) << exponent) + (sub << (exponent - SUB_BITS));
+        return low + (uint64_t(1) << (exponent - SUB_BITS)) - 1;
+    }
+
+    void merge(const Histogram& other) {
+        count += other.count;
+        total_ns += other.total_ns;
+        max_ns = std::max(max_ns, other.max_ns);
+        for (size_t i = 0; i < BUCKETS; ++i) buckets[i] += other.buckets[i];
+    }
+
+    uint64_t mean_ns() const { return count ? total_ns / count : 0; }
+
+    uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * (count - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen > rank) return std::min(bucket_limit(i), max_ns);
+        }
+        return max_ns;
+    }
+};
+
+// One timed span, for --stats-trace
+struct TraceEvent {
+    Metric metric;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+// Process-wide latency histograms. Each thread records into its own block
+// with plain relaxed stores, so recording never contends or takes a lock;
+// snapshot() sums the blocks of live threads and of threads that have exited.
+// With tracing on, each span is also kept as a TraceEvent for write_trace().
+class Metrics {
+public:
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    static void record(Metric metric, uint64_t start_ns, uint64_t end_ns) {
+        ThreadBlock& block = local_block();
+        uint64_t ns = end_ns - start_ns;
+        Cells& cells = block.cells[static_cast<size_t>(metric)];
+        bump(cells.count, 1);
+        bump(cells.total_ns, ns);
+        if (ns > cells.max_ns.load(std::memory_order_relaxed)) cells.max_ns.store(ns, std::memory_order_relaxed);
+        bump(cells.buckets[Histogram::bucket_of(ns)], 1);
+        if (tracing.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(block.trace_mutex);
+            if (block.trace.size() < MAX_TRACE_EVENTS) block.trace.push_back(TraceEvent{metric, start_ns, ns});
+            else block.trace_dropped++;
+        }
+    }
+
+    // Totals for every metric over the life of the process
+    static std::vector<Histogram> snapshot() {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        std::vector<Histogram> totals(retired.begin(), retired.end());
+        for (ThreadBlock* block : blocks) block->add_to(totals);
+        return totals;
+    }
+
+    // Keeps up to MAX_TRACE_EVENTS spans per thread from now on
+    static void start_trace() { tracing.store(true, std::memory_order_relaxed); }
+
+    // Writes the spans kept so far in the Chrome trace event format, which
+    // chrome://tracing, Perfetto and speedscope open as a flame chart
+    static bool write_trace(const std::string& path) {
+        std::ofstream out(path, std::ios::binary);
+        out << "{\"traceEvents\":[";
+        bool first = true;
+        size_t dropped = 0;
+        auto write_events = [&](const std::vector<TraceEvent>& events, size_t thread) {
+            char line[160];
+            for (const TraceEvent& event : events) {
+                snprintf(line, sizeof(line), "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",", METRIC_NAMES[static_cast<size_t>(event.metric)], thread,
+                         event.start_ns / 1000.0, event.duration_ns / 1000.0);
+                out << line;
+                first = false;
+            }
+        };
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            for (ThreadBlock* block : blocks) {
+                std::lock_guard<std::mutex> trace_lock(block->trace_mutex);
+                write_events(block->trace, block->thread);
+                dropped += block->trace_dropped;
+            }
+            for (const auto& events : retired_trace) write_events(events.second, events.first);
+            dropped += retired_dropped;
+        }
+        out << "\n],\"otherData\":{\"dropped_events\":\"" << dropped << "\"}}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    struct Cells {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+        std::atomic<uint64_t> buckets[Histogram::BUCKETS] = {};
+    };
+
+    struct ThreadBlock {
+        Cells cells[METRIC_COUNT];
+        size_t thread = 0;
+        std::mutex trace_mutex;
+        std::vector<TraceEvent> trace;
+        size_t trace_dropped = 0;
+
+        void add_to(std::vector<Histogram>& totals) const {
+            for (size_t m = 0; m < METRIC_COUNT; ++m) {
+                const Cells& from = cells[m];
+                Histogram& to = totals[m];
+                if (from.count.load(std::memory_order_relaxed) == 0) continue;
+                to.count += from.count.load(std::memory_order_relaxed);
+                to.total_ns += from.total_ns.load(std::memory_order_relaxed);
+                to.max_ns = std::max(to.max_ns, from.max_ns.load(std::memory_order_relaxed));
+                for (size_t i = 0; i < Histogram::BUCKETS; ++i) to.buckets[i] += from.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Registers the thread's block on first use and folds it into the
+    // retired totals when the thread exits
+    struct BlockOwner {
+        ThreadBlock* block = nullptr;
+
+        ~BlockOwner() {
+            if (!block) return;
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            block->add_to(retired);
+            if (!block->trace.empty()) retired_trace.emplace_back(block->thread, std::move(block->trace));
+            retired_dropped += block->trace_dropped;
+            blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+            delete block;
+        }
+    };
+
+    // Only the owning thread writes a block, so a load and a store are enough
+    static void bump(std::atomic<uint64_t>& cell, uint64_t by) {
+        cell.store(cell.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    static ThreadBlock& local_block() {
+        thread_local BlockOwner owner;
+        if (!owner.block) {
+            owner.block = new ThreadBlock();
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            owner.block->thread = ++thread_count;
+            blocks.push_back(owner.block);
+        }
+        return *owner.block;
+    }
+
+    static inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    static inline std::atomic<bool> tracing{false};
+    static inline std::mutex registry_mutex;
+    static inline std::vector<ThreadBlock*> blocks;
+    static inline std::vector<Histogram> retired = std::vector<Histogram>(METRIC_COUNT);
+    static inline std::vector<std::pair<size_t, std::vector<TraceEvent>>> retired_trace;
+    static inline size_t retired_dropped = 0;
+    static inline size_t thread_count = 0;
+};
+
+// Records the time from construction to stop() or destruction under `metric`
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Metric metric) : metric(metric), start(Metrics::now_ns()) {}
+    ~ScopedTimer() { stop(); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    void stop() {
+        if (stopped) return;
+        Metrics::record(metric, start, Metrics::now_ns());
+        stopped = true;
+    }
+
+private:
+    Metric metric;
+    uint64_t start;
+    bool stopped = false;
+};
+
+// Writes one JSON object per metric that has been recorded, in the same
+// shape as the benchmark results
+void write_metrics(std::ostream& out, const std::vector<Histogram>& totals) {
+    long long now = static_cast<long long>(time(0));
+    for (size_t m = 0; m < METRIC_COUNT; ++m) {
+        const Histogram& h = totals[m];
+        if (h.count == 0) continue;
+        out << "{\"time\":" << now << ",\"metric\":\"" << METRIC_NAMES[m] << "\",\"count\":" << h.count
+            << ",\"mean_ns\":" << h.mean_ns() << ",\"p50_ns\":" << h.percentile(0.50) << ",\"p90_ns\":" << h.percentile(0.90)
+            << ",\"p99_ns\":" << h.percentile(0.99) << ",\"max_ns\":" << h.max_ns << "}\n";
+    }
+}
+
+struct StatsConfig {
+    std::string file;                               // Empty: no stats file
+    std::chrono::milliseconds interval{10000};
+    std::string trace_file;                         // Empty: no tracing
+};
+
+// Rewrites the stats file every interval from a background thread, and once
+// more when stopped. The trace, if one was started, is written when stopped.
+class StatsWriter {
+public:
+    ~StatsWriter() { stop(); }
+
+    void start(const StatsConfig& stats_config) {
+        stop();
+        config = stats_config;
+        if (config.file.empty()) return;
+        stopping = false;
+        writer = std::thread(&StatsWriter::run, this);
+    }
+
+    void stop() {
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            writer.join();
+        }
+        if (!config.trace_file.empty()) Metrics::write_trace(config.trace_file);
+        config = StatsConfig();
+    }
+
+private:
+    StatsConfig config;
+    std::thread writer;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        for (;;) {
+            bool last = wake.wait_for(lock, config.interval, [this] { return stopping; });
+            write_file();
+            if (last) break;
+        }
+    }
+
+    // Through a temporary file, so readers never see half a file
+    void write_file() {
+        std::string temp_name = config.file + ".tmp";
+        {
+            std::ofstream out(temp_name);
+            write_metrics(out, Metrics::snapshot());
+            if (!out) return;
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_name, config.file, ec);
+    }
+};
+
+
+// --- Pricing ---
+// Money is handled in whole cents so prices are exact.
+
+uint32_t to_cents(float amount) {
+    return amount > 0 ? static_cast<uint32_t>(std::llround(static_cast<double>(amount) * 100.0)) : 0;
+}
+
+std::string format_money(long long cents) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%lld.%02lld", cents / 100, cents % 100);
+    return buf;
+}
+
+// A rental is billed as whole days, then 12 hour blocks, then single hours
+struct RateSplit {
+    uint32_t days, halves, hours;
+    explicit RateSplit(int total_hours)
+        : days(total_hours / 24), halves((total_hours % 24) / 12), hours((total_hours % 24) % 12) {}
+};
+
+long long price_in_cents(const RateSplit& split, uint32_t per_hour, uint32_t per_half, uint32_t per_day) {
+    return static_cast<long long>(split.days) * per_day + static_cast<long long>(split.halves) * per_half +
+           static_cast<long long>(split.hours) * per_hour;
+}
+
+// Prices `count` cars from struct-of-arrays rate columns into `totals`,
+// four cars per step where SSE2 is available
+void price_columns(const RateSplit& split, const uint32_t* per_hour, const uint32_t* per_half,
+                   const uint32_t* per_day, size_t count, long long* totals) {
+    size_t i = 0;
+#ifdef HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k_hours = _mm_set1_epi64x(split.hours);
+    const __m128i k_halves = _mm_set1_epi64x(split.halves);
+    const __m128i k_days = _mm_set1_epi64x(split.days);
+    for (; i + 4 <= count; i += 4) {
+        __m128i hour = _mm_loadu_si128(reinterpret_cast<const __m128i*>(per_hour + i));
+        __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(per_half + i));
+        __m128i day = _mm_loadu_si128(reinterpret_cast<const __m128i*>(per_day + i));
+        // Widen each pair of 32 bit rates to 64 bit lanes and multiply exactly
+        __m128i lo = _mm_add_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_unpacklo_epi32(hour, zero), k_hours),
+                                                 _mm_mul_epu32(_mm_unpacklo_epi32(half, zero), k_halves)),
+                                   _mm_mul_epu32(_mm_unpacklo_epi32(day, zero), k_days));
+        __m128i hi = _mm_add_epi64(_mm_add_epi64(_mm_mul_epu32(_mm_unpackhi_epi32(hour, zero), k_hours),
+                                                 _mm_mul_epu32(_mm_unpackhi_epi32(half, zero), k_halves)),
+                                   _mm_mul_epu32(_mm_unpackhi_epi32(day, zero), k_days));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(totals + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(totals + i + 2), hi);
+    }
+#endif
+    for (; i < count; ++i) {
+        totals[i] = price_in_cents(split, per_hour[i], per_half[i], per_day[i]);
+    }
+}
+
+// Price of one car for a bulk quote
+struct Quote {
+    size_t slot;
+    long long cents;
+};
+
+// A quoted car copied out of the fleet, so it stays valid after the fleet's
+// lock is released
+struct QuotedCar {
+    Car car;
+    std::string branch;
+    long long cents;
+};
+
+
+// --- Reservation Calendar ---
+
+// A booked rental window [start, end) in seconds since the epoch
+struct Reservation {
+    time_t start;
+    time_t end;
+    int customer_id;
+};
+
+// Non-overlapping reservations of one car ordered by start time, so checking a
+// window only looks at its two neighbours: O(log n).
+class ReservationCalendar {
+public:
+    bool is_free(time_t start, time_t end) const {
+        auto next = bookings.lower_bound(start);
+        if (next != bookings.end() && next->first < end) return false;
+        if (next != bookings.begin() && std::prev(next)->second.end > start) return false;
+        return true;
+    }
+
+    bool book(const Reservation& reservation) {
+        if (reservation.end <= reservation.start || !is_free(reservation.start, reservation.end)) return false;
+        bookings.emplace(reservation.start, reservation);
+        return true;
+    }
+
+    bool cancel(time_t start) { return bookings.erase(start) > 0; }
+
+    // Ends the booking in progress at `now`. Returns the shortened booking.
+    bool end_at(time_t now, Reservation& ended) {
+        auto next = bookings.upper_bound(now);
+        if (next == bookings.begin()) return false;
+        auto current = std::prev(next);
+        if (current->second.end <= now) return false;
+        current->second.end = now;
+        ended = current->second;
+        if (ended.start >= now) bookings.erase(current);
+        return true;
+    }
+
+    // Shortens the booking starting at `start` to end at `end` (journal replay)
+    void shorten(time_t start, time_t end) {
+        auto it = bookings.find(start);
+        if (it == bookings.end()) return;
+        if (end <= start) bookings.erase(it);
+        else if (end < it->second.end) it->second.end = end;
+    }
+
+    // Drops reservations that ended before `now`; the transaction log keeps the history
+    void prune(time_t now) {
+        while (!bookings.empty() && bookings.begin()->second.end <= now) bookings.erase(bookings.begin());
+    }
+
+    void clear() { bookings.clear(); }
+    size_t size() const { return bookings.size(); }
+    // Bookings never overlap, so the last one ends after all the others
+    bool booked_after(time_t now) const { return !bookings.empty() && bookings.rbegin()->second.end > now; }
+
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (const auto& entry : bookings) fn(entry.second);
+    }
+
+private:
+    std::map<time_t, Reservation> bookings;
+};
+
+
+// --- Fleet Store ---
+
+// Each car lives in exactly one slot for as long as it is in the fleet.
+enum CarState : uint8_t {
+    SLOT_FREE = 0,     // Slot is not holding a car (deleted or never used)
+    CAR_AVAILABLE,     // Car can be booked
+    CAR_MAINTENANCE,   // Car is out of service and left out of available.txt
+    CAR_RENTED         // Car is with a customer until it is returned
+};
+
+// What a car is doing right now. OVERDUE is a rented car past its due time;
+// it needs no transition of its own, so nothing has to wake up when a rental
+// runs late.
+enum class CarStatus { AVAILABLE, RENTED, OVERDUE, MAINTENANCE };
+
+const char* car_status_name(CarStatus status) {
+    switch (status) {
+        case CarStatus::AVAILABLE: return "AVAILABLE";
+        case CarStatus::RENTED: return "RENTED";
+        case CarStatus::OVERDUE: return "OVERDUE";
+        case CarStatus::MAINTENANCE: return "MAINTENANCE";
+    }
+    return "UNKNOWN";
+}
+
+// A car handed over to a customer. It stays out until returned, however long
+// past `due` that is.
+struct ActiveRental {
+    size_t slot;
+    int customer_id;
+    time_t start;
+    time_t due;        // End of the booked window
+};
+
+// One row of the rented cars list
+struct RentedCar {
+    std::string plate;
+    std::string brand;
+    std::string model;
+    std::string branch;
+    int customer_id;
+    std::string customer_name;
+    time_t start;
+    time_t due;
+    bool overdue;
+};
+
+// Set in a slot's state byte while one thread owns the car's calendar
+const uint8_t CAR_CLAIMED = 0x80;
+
+// Growable array of atomic state bytes. Growing moves the array, so it may only
+// happen while no other thread is reading (the fleet's exclusive lock).
+class SlotStates {
+public:
+    size_t size() const { return count; }
+    void clear() { count = 0; }
+
+    void push_back(uint8_t value) {
+        if (count == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : 64;
+            std::unique_ptr<std::atomic<uint8_t>[]> grown(new std::atomic<uint8_t>[new_capacity]);
+            for (size_t i = 0; i < count; ++i) grown[i].store(values[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            values = std::move(grown);
+            capacity = new_capacity;
+        }
+        values[count++].store(value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint8_t>& operator[](size_t i) const { return values[i]; }
+
+private:
+    std::unique_ptr<std::atomic<uint8_t>[]> values;
+    size_t count = 0;
+    size_t capacity = 0;
+};
+
+// Append-only storage for fleet strings. Strings are copied into large chunks
+// and NUL-terminated; chunks never move, so views into them stay valid until
+// clear().
+class StringArena {
+public:
+    std::string_view store(std::string_view text) {
+        size_t needed = text.size() + 1;
+        if (chunks.empty() || used + needed > chunk_size) {
+            chunk_size = std::max(CHUNK_SIZE, needed);
+            chunks.emplace_back(new char[chunk_size]);
+            used = 0;
+            reserved += chunk_size;
+        }
+        char* dest = chunks.back().get() + used;
+        std::memcpy(dest, text.data(), text.size());
+        dest[text.size()] = '\0';
+        used += needed;
+        return std::string_view(dest, text.size());
+    }
+
+    void clear() {
+        chunks.clear();
+        used = chunk_size = reserved = 0;
+    }
+
+    size_t bytes() const { return reserved; }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t used = 0;
+    size_t chunk_size = 0;
+    size_t reserved = 0;
+};
+
+// Maps each distinct string to a small ID. Brands, colours and transmissions
+// come from a handful of values, so the whole fleet shares one copy of each.
+// Strings are never freed one at a time; see FleetStore::compact_strings.
+class StringPool {
+public:
+    uint32_t intern(std::string_view text) {
+        auto it = ids.find(text);
+        if (it != ids.end()) return it->second;
+        std::string_view stored = arena.store(text);
+        uint32_t id = static_cast<uint32_t>(values.size());
+        values.push_back(stored);
+        ids.emplace(stored, id);
+        return id;
+    }
+
+    std::string_view get(uint32_t id) const { return values[id]; }
+
+    void clear() {
+        ids.clear();
+        values.clear();
+        arena.clear();
+    }
+
+    size_t size() const { return values.size(); }
+    size_t bytes() const {
+        return arena.bytes() + values.capacity() * sizeof(std::string_view) +
+               ids.size() * (sizeof(std::string_view) + 2 * sizeof(void*)) + ids.bucket_count() * sizeof(void*);
+    }
+
+private:
+    StringArena arena;
+    std::vector<std::string_view> values;
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+// Plate number in 16 bytes. Plates up to 15 characters are kept inline and
+// NUL-terminated; longer ones live in the string pool and text[0] is 0.
+struct PlateKey {
+    char text[16];
+};
+
+// Compact fleet entry: 40 bytes instead of five std::strings and four floats.
+// Rates are kept in cents in the fleet's rate columns.
+struct CarRecord {
+    PlateKey plate;
+    uint32_t brand;
+    uint32_t model;
+    uint32_t colour;
+    uint32_t transmission;
+    uint32_t branch;
+    float capacity;
+};
+
+// Branch whose data files live in the working directory; see RentalSystem
+const char MAIN_BRANCH[] = "main";
+
+// Read-only view of a fleet car with the same fields as Car. The strings point
+// into the fleet's storage (always NUL-terminated, so data() can be printed)
+// and are valid until the car is removed or the fleet is cleared.
+struct CarView {
+    std::string_view plate_num;
+    std::string_view brand;
+    std::string_view model;
+    float capacity;
+    std::string_view colour;
+    float rate_per_hour;
+    float rate_per_half;
+    float rate_per_day;
+    std::string_view transmission;
+    std::string_view branch;
+
+    Car to_car() const {
+        return Car{std::string(plate_num), std::string(brand), std::string(model), capacity, std::string(colour),
+                   rate_per_hour, rate_per_half, rate_per_day, std::string(transmission)};
+    }
+};
+
+// Categorical car fields with a bitmap index
+enum class CarField { BRAND, MODEL, COLOUR, TRANSMISSION, BRANCH };
+const size_t CAR_FIELD_COUNT = 5;
+
+// Which of a car's three rates a query filters and orders by
+enum class RateField { HOUR, HALF, DAY };
+
+// Search over the fleet. Empty strings match any value; the others compare
+// ignoring case. Results are the cars free for [start, end), cheapest first
+// by `rate`.
+struct CarQuery {
+    std::string brand;
+    std::string model;
+    std::string colour;
+    std::string transmission;
+    std::string branch;
+    float min_capacity = 0;
+    RateField rate = RateField::DAY;
+    long long min_cents = 0;
+    long long max_cents = -1;     // Negative = no upper bound
+    time_t start = 0;
+    time_t end = 0;
+    size_t limit = 0;             // 0 = all
+};
+
+// Index of the lowest set bit of a non-zero word
+int lowest_bit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+// Set of slots kept as the non-zero words of a bitmap, in word order. A value
+// held by a few cars costs a few words; one held by most of the fleet costs
+// about twice a plain bitmap.
+class SparseBitmap {
+public:
+    struct Word {
+        uint32_t index;
+        uint64_t bits;
+    };
+
+    void set(size_t slot) {
+        auto it = word_at(slot / 64);
+        if (it == words.end() || it->index != slot / 64) it = words.insert(it, Word{static_cast<uint32_t>(slot / 64), 0});
+        uint64_t bit = 1ULL << (slot % 64);
+        if (!(it->bits & bit)) count++;
+        it->bits |= bit;
+    }
+
+    void reset(size_t slot) {
+        auto it = word_at(slot / 64);
+        uint64_t bit = 1ULL << (slot % 64);
+        if (it == words.end() || it->index != slot / 64 || !(it->bits & bit)) return;
+        count--;
+        it->bits &= ~bit;
+        if (it->bits == 0) words.erase(it);
+    }
+
+    // Bits of word `index`, 0 if none are set
+    uint64_t bits(uint32_t index) const {
+        auto it = std::lower_bound(words.begin(), words.end(), index,
+                                   [](const Word& word, uint32_t i) { return word.index < i; });
+        return it != words.end() && it->index == index ? it->bits : 0;
+    }
+
+    bool test(size_t slot) const { return (bits(static_cast<uint32_t>(slot / 64)) >> (slot % 64)) & 1; }
+    size_t size() const { return count; }
+    const std::vector<Word>& all_words() const { return words; }
+
+    void unite(const SparseBitmap& other) {
+        for (const Word& word : other.words) {
+            for (uint64_t rest = word.bits; rest; rest &= rest - 1) set(word.index * 64 + lowest_bit(rest));
+        }
+    }
+
+private:
+    std::vector<Word> words;
+    size_t count = 0;
+
+    std::vector<Word>::iterator word_at(uint32_t index) {
+        if (!words.empty() && words.back().index < index) return words.end(); // Appending while building
+        return std::lower_bound(words.begin(), words.end(), index,
+                                [](const Word& word, uint32_t i) { return word.index < i; });
+    }
+};
+
+// One entry of a rate index: slots ordered by price, then slot
+struct RateEntry {
+    uint32_t cents;
+    uint32_t slot;
+    bool operator<(const RateEntry& other) const {
+        return cents != other.cents ? cents < other.cents : slot < other.slot;
+    }
+};
+
+// Single copy of the fleet, keyed by plate number. Availability is a one-byte
+// state per slot, so renting, deleting and resetting never copy Car records.
+// Each slot also owns the reservation calendar of its car. Cars are stored as
+// CarRecords over a shared string pool and handed out as CarViews.
+//
+// Searches go through secondary indexes: a bitmap of slots per brand, model,
+// colour and transmission, and the slots sorted by each rate. They are built
+// on the first query and then kept up to date by add and remove.
+//
+// Rented and in-maintenance cars are also kept in lists, so returning every
+// car and listing the rented ones only touch those cars.
+//
+// Threading: structural changes (add, remove, maintenance, clear) need
+// exclusive access. Everything else may run concurrently; a car's calendar and
+// rental are only touched after claiming the car with a CAS on its state byte,
+// so two threads can never book the same car at once and no fleet-wide lock is
+// held. The rented list has a mutex of its own.
+class FleetStore {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Owns a car's claim bit for as long as it is in scope
+    class CarClaim {
+    public:
+        CarClaim(const FleetStore& fleet, size_t slot) : cell(fleet.state[slot]) {
+            uint8_t expected = cell.load(std::memory_order_relaxed) & ~CAR_CLAIMED;
+            while (!cell.compare_exchange_weak(expected, expected | CAR_CLAIMED, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                if (expected & CAR_CLAIMED) {
+                    std::this_thread::yield();
+                    expected &= ~CAR_CLAIMED;
+                }
+            }
+        }
+        ~CarClaim() { cell.fetch_and(static_cast<uint8_t>(~CAR_CLAIMED), std::memory_order_release); }
+        CarClaim(const CarClaim&) = delete;
+        CarClaim& operator=(const CarClaim&) = delete;
+
+    private:
+        std::atomic<uint8_t>& cell;
+    };
+
+    void clear() {
+        cars.clear();
+        strings.clear();
+        branch_ids.clear();
+        calendars.clear();
+        rate_hour.clear();
+        rate_half.clear();
+        rate_day.clear();
+        state.clear();
+        free_slots.clear();
+        plate_table.clear();
+        rental_due.clear();
+        maintenance.clear();
+        rented.clear();
+        list_pos.clear();
+        live_total = 0;
+        for (auto& bitmaps : by_value) bitmaps.clear();
+        for (auto& sorted : by_rate) sorted.clear();
+        indexes_ready.store(false, std::memory_order_relaxed);
+    }
+
+    // Returns the slot holding the plate, or npos if there is no such car.
+    size_t find(std::string_view plate) const {
+        if (plate_table.empty()) return npos;
+        size_t mask = plate_table.size() - 1;
+        for (size_t pos = hash_plate(plate) & mask; plate_table[pos] != 0; pos = (pos + 1) & mask) {
+            size_t slot = plate_table[pos] - 1;
+            if (plate_of(slot) == plate) return slot;
+        }
+        return npos;
+    }
+
+    CarView at(size_t slot) const {
+        const CarRecord& car = cars[slot];
+        return CarView{plate_of(slot),
+                       strings.get(car.brand),
+                       strings.get(car.model),
+                       car.capacity,
+                       strings.get(car.colour),
+                       rate_hour[slot] / 100.0f,
+                       rate_half[slot] / 100.0f,
+                       rate_day[slot] / 100.0f,
+                       strings.get(car.transmission),
+                       strings.get(car.branch)};
+    }
+    size_t slot_count() const { return cars.size(); }
+    bool is_live(size_t slot) const { return state_of(slot) != SLOT_FREE; }
+    uint8_t state_of(size_t slot) const { return state[slot].load(std::memory_order_acquire) & ~CAR_CLAIMED; }
+    // Available or rented; these are the cars listed in available.txt
+    bool in_service(size_t slot) const {
+        uint8_t current = state_of(slot);
+        return current == CAR_AVAILABLE || current == CAR_RENTED;
+    }
+    bool is_rented(size_t slot) const { return state_of(slot) == CAR_RENTED; }
+    bool has_bookings(size_t slot, time_t now) const { return calendars[slot].booked_after(now); }
+    size_t size() const { return live_total; }
+    size_t in_service_count() const { return live_total - maintenance.size(); }
+
+    // Adds a car to a branch, in service or in maintenance. Returns npos if the
+    // plate is already taken.
+    size_t add(const Car& car, bool in_service, std::string_view branch = MAIN_BRANCH) {
+        if (find(car.plate_num) != npos) return npos;
+        CarRecord record = make_record(car);
+        record.branch = strings.intern(branch);
+        note_branch(record.branch);
+        size_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            cars[slot] = record;
+        } else {
+            slot = cars.size();
+            cars.push_back(record);
+            calendars.emplace_back();
+            rate_hour.push_back(0);
+            rate_half.push_back(0);
+            rate_day.push_back(0);
+            state.push_back(SLOT_FREE);
+            rental_due.push_back(0);
+            list_pos.push_back(npos);
+        }
+        rate_hour[slot] = to_cents(car.rate_per_hour);
+        rate_half[slot] = to_cents(car.rate_per_half);
+        rate_day[slot] = to_cents(car.rate_per_day);
+        state[slot].store(CAR_AVAILABLE, std::memory_order_relaxed);
+        live_total++;
+        index_plate(slot);
+        if (indexes_ready.load(std::memory_order_relaxed)) index_car(slot);
+        if (!in_service) set_in_service(slot, false);
+        return slot;
+    }
+
+    bool remove(std::string_view plate) {
+        size_t slot = find(plate);
+        if (slot == npos) return false;
+        set_in_service(slot, true); // Drops it from the maintenance list
+        drop_rental(slot);
+        unindex_plate(slot);
+        if (indexes_ready.load(std::memory_order_relaxed)) unindex_car(slot);
+        state[slot].store(SLOT_FREE, std::memory_order_relaxed);
+        cars[slot] = CarRecord();
+        calendars[slot].clear();
+        free_slots.push_back(slot);
+        live_total--;
+        return true;
+    }
+
+    // Replaces the details of the car in `slot`, keeping its plate, state and
+    // calendar
+    void update(size_t slot, const Car& car) {
+        bool indexed = indexes_ready.load(std::memory_order_relaxed);
+        if (indexed) unindex_car(slot);
+        PlateKey plate = cars[slot].plate;
+        uint32_t branch = cars[slot].branch;
+        cars[slot] = make_record(car);
+        cars[slot].plate = plate;
+        cars[slot].branch = branch;
+        rate_hour[slot] = to_cents(car.rate_per_hour);
+        rate_half[slot] = to_cents(car.rate_per_half);
+        rate_day[slot] = to_cents(car.rate_per_day);
+        if (indexed) index_car(slot);
+    }
+
+    // Moves the car to another branch; its state and calendar go with it
+    void move(size_t slot, std::string_view branch) {
+        bool indexed = indexes_ready.load(std::memory_order_relaxed);
+        if (indexed) unindex_car(slot);
+        cars[slot].branch = strings.intern(branch);
+        note_branch(cars[slot].branch);
+        if (indexed) index_car(slot);
+    }
+
+    // Every branch that has held a car since the fleet was cleared
+    std::vector<std::string_view> branch_list() const {
+        std::vector<std::string_view> names;
+        for (uint32_t id : branch_ids) names.push_back(strings.get(id));
+        return names;
+    }
+
+    // Moves a car between maintenance and service. A rented car has to be
+    // returned before it can be taken out of service; returns false for it.
+    bool set_in_service(size_t slot, bool in_service) {
+        uint8_t current = state_of(slot);
+        if (in_service == (current != CAR_MAINTENANCE)) return true;
+        if (!in_service && current == CAR_RENTED) return false;
+        if (in_service) {
+            size_t pos = list_pos[slot];
+            size_t last = maintenance.back();
+            maintenance[pos] = last;
+            list_pos[last] = pos;
+            maintenance.pop_back();
+            list_pos[slot] = npos;
+            state[slot].store(CAR_AVAILABLE, std::memory_order_relaxed);
+        } else {
+            list_pos[slot] = maintenance.size();
+            maintenance.push_back(slot);
+            state[slot].store(CAR_MAINTENANCE, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    CarStatus status(size_t slot, time_t now) const {
+        switch (state_of(slot)) {
+            case CAR_MAINTENANCE: return CarStatus::MAINTENANCE;
+            case CAR_RENTED: {
+                CarClaim claim(*this, slot);
+                if (state_of(slot) != CAR_RENTED) return CarStatus::AVAILABLE; // Returned meanwhile
+                return rental_due[slot] <= now ? CarStatus::OVERDUE : CarStatus::RENTED;
+            }
+            default: return CarStatus::AVAILABLE;
+        }
+    }
+
+    // Direct calendar access, for callers with exclusive access to the fleet
+    const ReservationCalendar& calendar(size_t slot) const { return calendars[slot]; }
+    ReservationCalendar& calendar(size_t slot) { return calendars[slot]; }
+
+    // True if the car can be booked for [start, end). A rented car can only
+    // be booked after it is due back, and an overdue one not at all.
+    bool is_free(size_t slot, time_t start, time_t end) const {
+        if (!in_service(slot)) return false;
+        CarClaim claim(*this, slot);
+        return back_by(slot, start) && calendars[slot].is_free(start, end);
+    }
+
+    // The transitions below call `then` after a change succeeds, while the car
+    // is still claimed. Journaling the change there keeps the records of one
+    // car in the order the changes were made, whatever other threads do.
+    struct NoFollowUp {
+        void operator()() const {}
+    };
+
+    // Books the car if the window is still free. Reservations that ended
+    // before `now` are pruned first.
+    template <typename Fn = NoFollowUp>
+    bool book(size_t slot, const Reservation& reservation, time_t now, Fn then = Fn()) {
+        if (!in_service(slot)) return false;
+        CarClaim claim(*this, slot);
+        if (!back_by(slot, reservation.start)) return false;
+        calendars[slot].prune(now);
+        if (!calendars[slot].book(reservation)) return false;
+        then();
+        return true;
+    }
+
+    // Books the car from now on and hands it over: AVAILABLE -> RENTED
+    template <typename Fn = NoFollowUp>
+    bool hand_over(size_t slot, const Reservation& reservation, time_t now, Fn then = Fn()) {
+        CarClaim claim(*this, slot);
+        if (state_of(slot) != CAR_AVAILABLE) return false;
+        calendars[slot].prune(now);
+        if (!calendars[slot].book(reservation)) return false;
+        start_rental(slot, reservation);
+        then();
+        return true;
+    }
+
+    // Takes the car back at `now`: RENTED -> AVAILABLE. A return before the
+    // due time frees the rest of the booked window. Returns false if the car
+    // is not rented.
+    template <typename Fn = NoFollowUp>
+    bool take_back(size_t slot, time_t now, ActiveRental& ended, Fn then = Fn()) {
+        CarClaim claim(*this, slot);
+        if (state_of(slot) != CAR_RENTED) return false;
+        ended = drop_rental(slot);
+        if (now < ended.due) calendars[slot].shorten(ended.start, now);
+        then();
+        return true;
+    }
+
+    // Marks a car rented without touching its calendar (journal replay,
+    // snapshot loading). Needs exclusive access.
+    void restore_rental(size_t slot, const Reservation& reservation) {
+        if (state_of(slot) != CAR_AVAILABLE) return;
+        start_rental(slot, reservation);
+    }
+
+    // Every car currently with a customer, soonest due first
+    std::vector<ActiveRental> rentals() const {
+        std::vector<ActiveRental> out;
+        {
+            std::lock_guard<std::mutex> lock(rented_mutex);
+            out = rented;
+        }
+        std::sort(out.begin(), out.end(), [](const ActiveRental& a, const ActiveRental& b) {
+            return a.due != b.due ? a.due < b.due : a.slot < b.slot;
+        });
+        return out;
+    }
+
+    // Cuts the booking in progress at `now` short. Returns false if there is none.
+    template <typename Fn = NoFollowUp>
+    bool end_booking(size_t slot, time_t now, Reservation& ended, Fn then = Fn()) {
+        CarClaim claim(*this, slot);
+        if (!calendars[slot].end_at(now, ended)) return false;
+        then();
+        return true;
+    }
+
+    // Undoes book() or hand_over() of `reservation` (a batch rolling back)
+    void cancel_booking(size_t slot, const Reservation& reservation, bool handed_over) {
+        CarClaim claim(*this, slot);
+        if (handed_over && state_of(slot) == CAR_RENTED) drop_rental(slot);
+        calendars[slot].cancel(reservation.start);
+    }
+
+    // Calls fn(slot, car) for every car that can be booked for [start, end)
+    template <typename Fn>
+    void for_each_free(time_t start, time_t end, Fn fn) const {
+        for (size_t slot = 0; slot < cars.size(); ++slot) {
+            if (is_free(slot, start, end)) fn(slot, at(slot));
+        }
+    }
+
+    // Drops every reservation
+    void clear_reservations() {
+        for (auto& cal : calendars) cal.clear();
+    }
+
+    // Puts every rented and in-maintenance car back in service without a
+    // return, touching only those slots.
+    void make_all_available() {
+        for (size_t slot : maintenance) {
+            state[slot].store(CAR_AVAILABLE, std::memory_order_relaxed);
+            list_pos[slot] = npos;
+        }
+        maintenance.clear();
+        for (const ActiveRental& rental : rented) {
+            state[rental.slot].store(CAR_AVAILABLE, std::memory_order_relaxed);
+            rental_due[rental.slot] = 0;
+            list_pos[rental.slot] = npos;
+        }
+        rented.clear();
+    }
+
+    // Calls fn(slot, car) for every car in the fleet (or only those in service).
+    template <typename Fn>
+    void for_each(bool in_service_only, Fn fn) const {
+        for (size_t slot = 0; slot < cars.size(); ++slot) {
+            uint8_t current = state_of(slot);
+            if (current == SLOT_FREE) continue;
+            if (in_service_only && current == CAR_MAINTENANCE) continue;
+            fn(slot, at(slot));
+        }
+    }
+
+    // Prices every car free for `hours` from `start` in one pass over the rate
+    // columns. Returns the cheapest `limit` cars (0 = all) costing at most
+    // `budget_cents` (negative = no budget), cheapest first.
+    std::vector<Quote> quote_all(time_t start, int hours, size_t limit, long long budget_cents) const {
+        std::vector<long long> totals(cars.size());
+        price_columns(RateSplit(hours), rate_hour.data(), rate_half.data(), rate_day.data(), cars.size(), totals.data());
+
+        std::vector<Quote> quotes;
+        quotes.reserve(in_service_count());
+        time_t end = start + static_cast<time_t>(hours) * 3600;
+        for (size_t slot = 0; slot < cars.size(); ++slot) {
+            if (budget_cents >= 0 && totals[slot] > budget_cents) continue;
+            if (!is_free(slot, start, end)) continue;
+            quotes.push_back(Quote{slot, totals[slot]});
+        }
+        auto cheaper = [](const Quote& a, const Quote& b) {
+            return a.cents != b.cents ? a.cents < b.cents : a.slot < b.slot;
+        };
+        if (limit > 0 && limit < quotes.size()) {
+            std::partial_sort(quotes.begin(), quotes.begin() + limit, quotes.end(), cheaper);
+            quotes.resize(limit);
+        } else {
+            std::sort(quotes.begin(), quotes.end(), cheaper);
+        }
+        return quotes;
+    }
+
+    // Cars matching `query`, cheapest first. Only the cars picked out by the
+    // indexes are looked at: either the intersection of the field bitmaps, or
+    // the slots in the price range in price order (stopping at the limit),
+    // whichever is expected to be smaller.
+    std::vector<Quote> query(const CarQuery& query) const {
+        build_indexes();
+        std::vector<Quote> found;
+        const std::vector<uint32_t>& rates = rate_column(query.rate);
+        const std::vector<RateEntry>& sorted = by_rate[static_cast<size_t>(query.rate)];
+        if (query.max_cents >= 0 && query.max_cents < query.min_cents) return found;
+        uint32_t low = static_cast<uint32_t>(std::min<long long>(std::max(query.min_cents, 0LL), UINT32_MAX));
+        uint32_t high = query.max_cents < 0 ? UINT32_MAX : static_cast<uint32_t>(std::min<long long>(query.max_cents, UINT32_MAX));
+        auto first = std::lower_bound(sorted.begin(), sorted.end(), RateEntry{low, 0});
+        auto last = std::upper_bound(first, sorted.end(), RateEntry{high, UINT32_MAX});
+
+        std::deque<SparseBitmap> merged;
+        std::vector<const SparseBitmap*> filters;
+        if (!field_filters(query, merged, filters)) return found;
+
+        // Estimated entries the price walk visits before it has `limit` matches,
+        // assuming the fields are independent of price
+        double walk = static_cast<double>(last - first);
+        if (query.limit > 0) {
+            double selectivity = 1;
+            for (const SparseBitmap* filter : filters) selectivity *= static_cast<double>(filter->size()) / std::max<size_t>(1, live_total);
+            walk = std::min(walk, query.limit / std::max(selectivity, 1e-9));
+        }
+        auto accept = [&](size_t slot) {
+            return cars[slot].capacity >= query.min_capacity && is_free(slot, query.start, query.end);
+        };
+        if (!filters.empty() && static_cast<double>(filters[0]->size()) < walk) {
+            for (const SparseBitmap::Word& word : filters[0]->all_words()) {
+                uint64_t bits = word.bits;
+                for (size_t i = 1; i < filters.size() && bits; ++i) bits &= filters[i]->bits(word.index);
+                for (; bits; bits &= bits - 1) {
+                    size_t slot = word.index * 64 + lowest_bit(bits);
+                    if (rates[slot] < low || rates[slot] > high || !accept(slot)) continue;
+                    found.push_back(Quote{slot, rates[slot]});
+                }
+            }
+            auto cheaper = [](const Quote& a, const Quote& b) {
+                return a.cents != b.cents ? a.cents < b.cents : a.slot < b.slot;
+            };
+            if (query.limit > 0 && query.limit < found.size()) {
+                std::partial_sort(found.begin(), found.begin() + query.limit, found.end(), cheaper);
+                found.resize(query.limit);
+            } else {
+                std::sort(found.begin(), found.end(), cheaper);
+            }
+        } else {
+            for (auto it = first; it != last && (query.limit == 0 || found.size() < query.limit); ++it) {
+                bool match = true;
+                for (size_t i = 0; i < filters.size() && match; ++i) match = filters[i]->test(it->slot);
+                if (match && accept(it->slot)) found.push_back(Quote{it->slot, it->cents});
+            }
+        }
+        return found;
+    }
+
+    // Cars in service among slots [first, last) matching the query's fields and
+    // minimum capacity, priced for `hours` and costing at most `budget_cents`
+    // (negative = no budget), in slot order. `first` must be a multiple of 64.
+    // Calendars, the rate range and the limit are not looked at.
+    std::vector<Quote> priced_matches(const CarQuery& query, int hours, long long budget_cents, size_t first,
+                                      size_t last) const {
+        build_indexes();
+        std::vector<Quote> found;
+        last = std::min(last, cars.size());
+        if (first >= last) return found;
+        std::deque<SparseBitmap> merged;
+        std::vector<const SparseBitmap*> filters;
+        if (!field_filters(query, merged, filters)) return found;
+
+        RateSplit split(hours);
+        auto consider = [&](size_t slot, long long cents) {
+            if (!in_service(slot) || cars[slot].capacity < query.min_capacity) return;
+            if (budget_cents < 0 || cents <= budget_cents) found.push_back(Quote{slot, cents});
+        };
+        if (filters.empty()) {
+            std::vector<long long> totals(last - first);
+            price_columns(split, rate_hour.data() + first, rate_half.data() + first, rate_day.data() + first,
+                          last - first, totals.data());
+            for (size_t slot = first; slot < last; ++slot) consider(slot, totals[slot - first]);
+            return found;
+        }
+        const std::vector<SparseBitmap::Word>& words = filters[0]->all_words();
+        auto word = std::lower_bound(words.begin(), words.end(), first / 64,
+                                     [](const SparseBitmap::Word& w, size_t index) { return w.index < index; });
+        for (; word != words.end() && word->index * size_t(64) < last; ++word) {
+            uint64_t bits = word->bits;
+            for (size_t i = 1; i < filters.size() && bits; ++i) bits &= filters[i]->bits(word->index);
+            for (; bits; bits &= bits - 1) {
+                size_t slot = word->index * 64 + lowest_bit(bits);
+                if (slot >= last) break;
+                consider(slot, price_in_cents(split, rate_hour[slot], rate_half[slot], rate_day[slot]));
+            }
+        }
+        return found;
+    }
+
+    // Moves the strings still used by a car or a branch into a fresh pool and
+    // renumbers them in the records and indexes, so the values of deleted and
+    // edited cars stop taking memory. Returns false, changing nothing, if every
+    // string is still in use. Invalidates every CarView; needs exclusive access.
+    bool compact_strings() {
+        const uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(strings.size(), UNUSED);
+        StringPool fresh;
+        auto keep = [&](uint32_t id) {
+            if (remap[id] == UNUSED) remap[id] = fresh.intern(strings.get(id));
+        };
+        auto for_each_id = [&](auto fn) {
+            for (size_t slot = 0; slot < cars.size(); ++slot) {
+                if (!is_live(slot)) continue;
+                CarRecord& car = cars[slot];
+                if (car.plate.text[0] == '\0') {
+                    uint32_t id;
+                    std::memcpy(&id, car.plate.text + 1, sizeof(id));
+                    fn(id);
+                    std::memcpy(car.plate.text + 1, &id, sizeof(id));
+                }
+                for (uint32_t* id : {&car.brand, &car.model, &car.colour, &car.transmission, &car.branch}) fn(*id);
+            }
+            for (uint32_t& id : branch_ids) fn(id);
+        };
+        for_each_id([&](uint32_t& id) { keep(id); });
+        if (fresh.size() == strings.size()) return false;
+        for_each_id([&](uint32_t& id) { id = remap[id]; });
+        if (indexes_ready.load(std::memory_order_relaxed)) {
+            for (auto& bitmaps : by_value) {
+                std::vector<SparseBitmap> renumbered(fresh.size());
+                for (uint32_t id = 0; id < bitmaps.size(); ++id) {
+                    if (remap[id] != UNUSED) renumbered[remap[id]] = std::move(bitmaps[id]);
+                }
+                bitmaps = std::move(renumbered);
+            }
+        }
+        strings = std::move(fresh);
+        return true;
+    }
+
+    // Approximate bytes used by the car records, rates, strings and plate index
+    size_t memory_usage() const {
+        return cars.capacity() * sizeof(CarRecord) + 3 * rate_hour.capacity() * sizeof(uint32_t) +
+               plate_table.capacity() * sizeof(uint32_t) + strings.bytes();
+    }
+
+private:
+    // Bitmaps of the fields `query` asks for, smallest first; values that
+    // differ only in case are merged into `merged`. False if some field
+    // matches no car.
+    bool field_filters(const CarQuery& query, std::deque<SparseBitmap>& merged,
+                       std::vector<const SparseBitmap*>& filters) const {
+        const std::string* wanted[CAR_FIELD_COUNT] = {&query.brand, &query.model, &query.colour, &query.transmission,
+                                                      &query.branch};
+        for (size_t field = 0; field < CAR_FIELD_COUNT; ++field) {
+            if (wanted[field]->empty()) continue;
+            const SparseBitmap* match = nullptr;
+            bool owned = false;
+            const auto& bitmaps = by_value[field];
+            for (uint32_t id = 0; id < bitmaps.size(); ++id) {
+                if (bitmaps[id].size() == 0 || !equals_ignore_case(strings.get(id), *wanted[field])) continue;
+                if (!match) {
+                    match = &bitmaps[id];
+                    continue;
+                }
+                if (!owned) {
+                    merged.push_back(*match);
+                    owned = true;
+                }
+                merged.back().unite(bitmaps[id]);
+                match = &merged.back();
+            }
+            if (!match) return false;
+            filters.push_back(match);
+        }
+        std::sort(filters.begin(), filters.end(),
+                  [](const SparseBitmap* a, const SparseBitmap* b) { return a->size() < b->size(); });
+        return true;
+    }
+
+    // True unless the car is rented and not back by `start`. Call with the car claimed.
+    bool back_by(size_t slot, time_t start) const {
+        if (state_of(slot) != CAR_RENTED) return true;
+        time_t due = rental_due[slot];
+        return start >= due && due > time(0);
+    }
+
+    // Call with the car claimed, or with exclusive access
+    void start_rental(size_t slot, const Reservation& reservation) {
+        rental_due[slot] = reservation.end;
+        {
+            std::lock_guard<std::mutex> lock(rented_mutex);
+            list_pos[slot] = rented.size();
+            rented.push_back(ActiveRental{slot, reservation.customer_id, reservation.start, reservation.end});
+        }
+        // Keeps the claim bit if the caller holds it
+        uint8_t claimed = state[slot].load(std::memory_order_relaxed) & CAR_CLAIMED;
+        state[slot].store(CAR_RENTED | claimed, std::memory_order_release);
+    }
+
+    // Ends the car's rental, if any, without a return: RENTED -> AVAILABLE.
+    // Call with the car claimed, or with exclusive access.
+    ActiveRental drop_rental(size_t slot) {
+        if (state_of(slot) != CAR_RENTED) return ActiveRental{slot, 0, 0, 0};
+        ActiveRental ended;
+        {
+            std::lock_guard<std::mutex> lock(rented_mutex);
+            size_t pos = list_pos[slot];
+            ended = rented[pos];
+            rented[pos] = rented.back();
+            list_pos[rented[pos].slot] = pos;
+            rented.pop_back();
+            list_pos[slot] = npos;
+        }
+        rental_due[slot] = 0;
+        uint8_t claimed = state[slot].load(std::memory_order_relaxed) & CAR_CLAIMED;
+        state[slot].store(CAR_AVAILABLE | claimed, std::memory_order_release);
+        return ended;
+    }
+
+    CarRecord make_record(const Car& car) {
+        CarRecord record{};
+        if (!car.plate_num.empty() && car.plate_num.size() < sizeof(record.plate.text)) {
+            std::memcpy(record.plate.text, car.plate_num.data(), car.plate_num.size());
+        } else {
+            uint32_t id = strings.intern(car.plate_num);
+            std::memcpy(record.plate.text + 1, &id, sizeof(id));
+        }
+        record.brand = strings.intern(car.brand);
+        record.model = strings.intern(car.model);
+        record.colour = strings.intern(car.colour);
+        record.transmission = strings.intern(car.transmission);
+        record.capacity = car.capacity;
+        return record;
+    }
+
+    std::string_view plate_of(size_t slot) const {
+        const PlateKey& plate = cars[slot].plate;
+        if (plate.text[0] != '\0') return std::string_view(plate.text);
+        uint32_t id;
+        std::memcpy(&id, plate.text + 1, sizeof(id));
+        return strings.get(id);
+    }
+
+    void note_branch(uint32_t id) {
+        if (std::find(branch_ids.begin(), branch_ids.end(), id) == branch_ids.end()) branch_ids.push_back(id);
+    }
+
+    static size_t hash_plate(std::string_view plate) { return std::hash<std::string_view>()(plate); }
+
+    // The plate index is an open-addressing table of slot + 1 (0 = empty)
+    // with linear probing, kept at most half full.
+    void index_plate(size_t slot) {
+        if (live_total * 2 > plate_table.size()) {
+            std::vector<uint32_t> old(std::max<size_t>(64, plate_table.size() * 2), 0);
+            old.swap(plate_table);
+            for (uint32_t entry : old) {
+                if (entry != 0) place(entry);
+            }
+        }
+        place(static_cast<uint32_t>(slot + 1));
+    }
+
+    void place(uint32_t entry) {
+        size_t mask = plate_table.size() - 1;
+        size_t pos = hash_plate(plate_of(entry - 1)) & mask;
+        while (plate_table[pos] != 0) pos = (pos + 1) & mask;
+        plate_table[pos] = entry;
+    }
+
+    // Removes the slot and shifts later entries of its probe run back into the gap
+    void unindex_plate(size_t slot) {
+        size_t mask = plate_table.size() - 1;
+        size_t pos = hash_plate(plate_of(slot)) & mask;
+        while (plate_table[pos] != slot + 1) pos = (pos + 1) & mask;
+        for (size_t next = (pos + 1) & mask; plate_table[next] != 0; next = (next + 1) & mask) {
+            size_t home = hash_plate(plate_of(plate_table[next] - 1)) & mask;
+            if (((next - home) & mask) >= ((next - pos) & mask)) {
+                plate_table[pos] = plate_table[next];
+                pos = next;
+            }
+        }
+        plate_table[pos] = 0;
+    }
+
+    void index_car(size_t slot) {
+        const CarRecord& car = cars[slot];
+        uint32_t ids[CAR_FIELD_COUNT] = {car.brand, car.model, car.colour, car.transmission, car.branch};
+        for (size_t field = 0; field < CAR_FIELD_COUNT; ++field) {
+            if (by_value[field].size() <= ids[field]) by_value[field].resize(strings.size());
+            by_value[field][ids[field]].set(slot);
+        }
+        for (size_t rate = 0; rate < 3; ++rate) {
+            RateEntry entry{rate_column(static_cast<RateField>(rate))[slot], static_cast<uint32_t>(slot)};
+            auto& sorted = by_rate[rate];
+            sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), entry), entry);
+        }
+    }
+
+    void unindex_car(size_t slot) {
+        const CarRecord& car = cars[slot];
+        uint32_t ids[CAR_FIELD_COUNT] = {car.brand, car.model, car.colour, car.transmission, car.branch};
+        for (size_t field = 0; field < CAR_FIELD_COUNT; ++field) by_value[field][ids[field]].reset(slot);
+        for (size_t rate = 0; rate < 3; ++rate) {
+            RateEntry entry{rate_column(static_cast<RateField>(rate))[slot], static_cast<uint32_t>(slot)};
+            auto& sorted = by_rate[rate];
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), entry);
+            if (it != sorted.end() && it->slot == entry.slot) sorted.erase(it);
+        }
+    }
+
+    // Builds every index in one pass over the slots, so loading a fleet never
+    // pays for incremental inserts
+    void build_indexes() const {
+        if (indexes_ready.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(index_mutex);
+        if (indexes_ready.load(std::memory_order_relaxed)) return;
+        for (auto& bitmaps : by_value) bitmaps.assign(strings.size(), SparseBitmap());
+        for (auto& sorted : by_rate) {
+            sorted.clear();
+            sorted.reserve(live_total);
+        }
+        for (size_t slot = 0; slot < cars.size(); ++slot) {
+            if (!is_live(slot)) continue;
+            const CarRecord& car = cars[slot];
+            uint32_t ids[CAR_FIELD_COUNT] = {car.brand, car.model, car.colour, car.transmission, car.branch};
+            for (size_t field = 0; field < CAR_FIELD_COUNT; ++field) by_value[field][ids[field]].set(slot);
+            for (size_t rate = 0; rate < 3; ++rate) {
+                by_rate[rate].push_back(RateEntry{rate_column(static_cast<RateField>(rate))[slot], static_cast<uint32_t>(slot)});
+            }
+        }
+        for (auto& sorted : by_rate) std::sort(sorted.begin(), sorted.end());
+        indexes_ready.store(true, std::memory_order_release);
+    }
+
+    const std::vector<uint32_t>& rate_column(RateField rate) const {
+        return rate == RateField::HOUR ? rate_hour : rate == RateField::HALF ? rate_half : rate_day;
+    }
+
+    std::vector<CarRecord> cars;
+    StringPool strings;
+    std::vector<uint32_t> branch_ids;      // String pool IDs of the branches in use
+    std::vector<ReservationCalendar> calendars;
+    std::vector<uint32_t> rate_hour;       // Rates in cents, one column per rate
+    std::vector<uint32_t> rate_half;
+    std::vector<uint32_t> rate_day;
+    mutable SlotStates state;              // CarState per slot, plus CAR_CLAIMED
+    std::vector<size_t> free_slots;
+    std::vector<uint32_t> plate_table;
+    mutable std::vector<SparseBitmap> by_value[CAR_FIELD_COUNT]; // Indexed by string pool ID
+    mutable std::vector<RateEntry> by_rate[3];                     // One per RateField
+    mutable std::atomic<bool> indexes_ready{false};
+    mutable std::mutex index_mutex;
+    std::vector<time_t> rental_due;        // Due time of each rented car
+    std::vector<size_t> maintenance;       // Slots in maintenance
+    std::vector<ActiveRental> rented;      // Cars with a customer, guarded by rented_mutex
+    mutable std::mutex rented_mutex;
+    std::vector<size_t> list_pos;          // Position of each slot in `maintenance` or `rented`
+    size_t live_total = 0;
+};
+
+
+// --- Customer Directory ---
+
+// Customer fields that can be searched by prefix
+enum class CustomerField { NAME, PHONE, IC };
+
+// Sorted index over one customer field, for search-as-you-type. Entries carry
+// the first 8 case-folded bytes of the key, so most comparisons never touch
+// the Customer record. New customers go to a small sorted delta that is merged
+// into the base once it grows past roughly sqrt(n) entries.
+class PrefixIndex {
+public:
+    explicit PrefixIndex(CustomerField field) : field(field) {}
+
+    void rebuild(const std::vector<Customer>& records) {
+        base.resize(records.size());
+        for (size_t i = 0; i < records.size(); ++i) base[i] = Entry{head(key(records[i])), static_cast<uint32_t>(i)};
+        std::sort(base.begin(), base.end(), [&](const Entry& a, const Entry& b) { return less(records, a, b); });
+        delta.clear();
+    }
+
+    void insert(const std::vector<Customer>& records, size_t index) {
+        Entry entry{head(key(records[index])), static_cast<uint32_t>(index)};
+        auto comp = [&](const Entry& a, const Entry& b) { return less(records, a, b); };
+        delta.insert(std::upper_bound(delta.begin(), delta.end(), entry, comp), entry);
+        if (delta.size() * delta.size() > std::max<size_t>(base.size(), 1 << 20)) {
+            std::vector<Entry> merged(base.size() + delta.size());
+            std::merge(base.begin(), base.end(), delta.begin(), delta.end(), merged.begin(), comp);
+            base.swap(merged);
+            delta.clear();
+        }
+    }
+
+    // Appends up to `limit` record indexes whose key starts with `prefix`
+    // (ignoring ASCII case), in key order
+    void search(const std::vector<Customer>& records, std::string_view prefix, size_t limit,
+                std::vector<size_t>& out) const {
+        uint64_t prefix_head = head(prefix);
+        auto below = [&](const Entry& entry, int) {
+            if (entry.head != prefix_head) return entry.head < prefix_head;
+            return compare_folded(key(records[entry.index]), prefix) < 0;
+        };
+        auto matches = [&](const Entry& entry) {
+            std::string_view text = key(records[entry.index]);
+            return text.size() >= prefix.size() && compare_folded(text.substr(0, prefix.size()), prefix) == 0;
+        };
+        auto a = std::lower_bound(base.begin(), base.end(), 0, below);
+        auto b = std::lower_bound(delta.begin(), delta.end(), 0, below);
+        while (out.size() < limit) {
+            bool more_a = a != base.end() && matches(*a);
+            bool more_b = b != delta.end() && matches(*b);
+            if (!more_a && !more_b) break;
+            if (more_a && (!more_b || !less(records, *b, *a))) out.push_back((a++)->index);
+            else out.push_back((b++)->index);
+        }
+    }
+
+    static std::string_view key(const Customer& cust, CustomerField field) {
+        switch (field) {
+            case CustomerField::NAME: return cust.name;
+            case CustomerField::PHONE: return cust.phone;
+            default: return cust.ic;
+        }
+    }
+
+    static unsigned char fold(char c) { return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c); }
+
+    // First 8 folded bytes, big-endian and zero padded, so comparing heads
+    // compares the first 8 bytes of the keys
+    static uint64_t head(std::string_view text) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; ++i) value = value << 8 | (i < text.size() ? fold(text[i]) : 0);
+        return value;
+    }
+
+    static int compare_folded(std::string_view a, std::string_view b) {
+        size_t n = std::min(a.size(), b.size());
+        for (size_t i = 0; i < n; ++i) {
+            if (fold(a[i]) != fold(b[i])) return fold(a[i]) < fold(b[i]) ? -1 : 1;
+        }
+        return a.size() < b.size() ? -1 : a.size() > b.size();
+    }
+
+private:
+    struct Entry {
+        uint64_t head;      // head() of the key
+        uint32_t index;     // Position in the directory's records
+    };
+
+    CustomerField field;
+    std::vector<Entry> base;
+    std::vector<Entry> delta;
+
+    std::string_view key(const Customer& cust) const { return key(cust, field); }
+
+    // Key order, then record order so customers with equal keys stay stable
+    bool less(const std::vector<Customer>& records, const Entry& a, const Entry& b) const {
+        if (a.head != b.head) return a.head < b.head;
+        int order = compare_folded(key(records[a.index]), key(records[b.index]));
+        return order != 0 ? order < 0 : a.index < b.index;
+    }
+};
+
+// All registered customers in registration order, with a hash index on ID,
+// prefix indexes on name, phone and IC, and the allocator for new IDs. IDs are
+// handed out above the highest ID ever seen, so the file order does not matter.
+// The prefix indexes are built on the first search, so runs that never search
+// do not pay for the sorts at startup.
+//
+// Threading: RentalSystem guards it with data_mutex. The lazy index build has
+// its own lock, so concurrent searches under a shared lock are safe.
+class CustomerDirectory {
+public:
+    static const int FIRST_ID = 1001;
+
+    // Replaces every customer. Records whose ID is already taken are dropped
+    // and returned.
+    std::vector<Customer> assign(std::vector<Customer> loaded) {
+        std::vector<Customer> duplicates;
+        records.clear();
+        by_id.clear();
+        by_id.reserve(loaded.size());
+        next = FIRST_ID;
+        indexes_ready.store(false, std::memory_order_relaxed);
+        for (auto& cust : loaded) {
+            if (!by_id.emplace(cust.id, static_cast<uint32_t>(records.size())).second) {
+                duplicates.push_back(std::move(cust));
+                continue;
+            }
+            next = std::max(next, cust.id + 1);
+            records.push_back(std::move(cust));
+        }
+        return duplicates;
+    }
+
+    // Adds a customer that already has an ID. Returns false if the ID is taken.
+    bool insert(const Customer& cust) {
+        if (!by_id.emplace(cust.id, static_cast<uint32_t>(records.size())).second) return false;
+        next = std::max(next, cust.id + 1);
+        records.push_back(cust);
+        if (indexes_ready.load(std::memory_order_relaxed)) {
+            for (PrefixIndex* index : {&by_name, &by_phone, &by_ic}) index->insert(records, records.size() - 1);
+        }
+        return true;
+    }
+
+    // Gives the customer the next free ID and adds it. Returns the ID.
+    int add(Customer cust) {
+        cust.id = next;
+        insert(cust);
+        return cust.id;
+    }
+
+    int next_id() const { return next; }
+    size_t size() const { return records.size(); }
+
+    const Customer* find(int id) const {
+        auto it = by_id.find(id);
+        return it == by_id.end() ? nullptr : &records[it->second];
+    }
+
+    // Up to `limit` customers whose field starts with `prefix`, ignoring case,
+    // sorted by that field
+    std::vector<const Customer*> search(CustomerField field, std::string_view prefix, size_t limit) const {
+        build_indexes();
+        const PrefixIndex& index = field == CustomerField::NAME ? by_name : field == CustomerField::PHONE ? by_phone : by_ic;
+        std::vector<size_t> found;
+        index.search(records, prefix, limit, found);
+        std::vector<const Customer*> result;
+        for (size_t i : found) result.push_back(&records[i]);
+        return result;
+    }
+
+private:
+    std::vector<Customer> records;
+    std::unordered_map<int, uint32_t> by_id;
+    mutable PrefixIndex by_name{CustomerField::NAME};
+    mutable PrefixIndex by_phone{CustomerField::PHONE};
+    mutable PrefixIndex by_ic{CustomerField::IC};
+    mutable std::atomic<bool> indexes_ready{false};
+    mutable std::mutex index_mutex;
+    int next = FIRST_ID;
+
+    // The three sorts are independent, so large directories run them side by side
+    void build_indexes() const {
+        if (indexes_ready.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(index_mutex);
+        if (indexes_ready.load(std::memory_order_relaxed)) return;
+        if (records.size() < 100000) {
+            for (PrefixIndex* index : {&by_name, &by_phone, &by_ic}) index->rebuild(records);
+        } else {
+            std::thread name([this] { by_name.rebuild(records); });
+            std::thread phone([this] { by_phone.rebuild(records); });
+            by_ic.rebuild(records);
+            name.join();
+            phone.join();
+        }
+        indexes_ready.store(true, std::memory_order_release);
+    }
+};
+
+
+// --- Fleet Journal ---
+
+// Reads/writes one car in the whitespace separated layout of car rental.txt
+bool read_car_record(std::istream& in, Car& car) {
+    return static_cast<bool>(in >> car.plate_num >> car.brand >> car.model >> car.capacity >> car.colour
+                                >> car.rate_per_hour >> car.rate_per_half >> car.rate_per_day >> car.transmission);
+}
+
+// Takes a Car or a CarView
+template <typename CarFields>
+void write_car_record(std::ostream& out, const CarFields& car) {
+    out << car.plate_num << " " << car.brand << " " << car.model << " "
+        << car.capacity << " " << car.colour << " " << car.rate_per_hour << " "
+        << car.rate_per_half << " " << car.rate_per_day << " " << car.transmission;
+}
+
+// Forces buffered file contents to disk
+void sync_file(FILE* file) {
+    fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+void write_customer_record(std::ostream& out, const Customer& cust) {
+    out << cust.id << ";" << cust.name << ";" << cust.phone << ";" << cust.ic << ";" << cust.address;
+}
+
+// Append-only log of changes made since the last snapshot (fleet.snap).
+// One record per line:
+//   B <plate> <start> <end> <customer id>   car booked for [start, end)
+//   O <plate> <start> <due> <customer id>   car booked for [start, due) and handed over
+//   I <plate> <time>                        rented car returned at <time>
+//   E <plate> <start> <end>                 booking starting at <start> returned early at <end>
+//   K <plate> <start> <end> <customer id>   booking dropped when the car was deleted
+//   R <plate>         car put into maintenance
+//   T <plate>         car back in service
+//   A <car record>    car added, same fields as car rental.txt
+//   D <plate>         car deleted
+//   X                 every car reset to available and all bookings dropped
+//   C <customer>      customer registered (older journals only; see Customer Store)
+//   G <count>         the next <count> records were written together (a batch
+//                     booking) and are replayed all together or not at all
+// Records reach the OS on every append but are fsync'ed in batches. A last line
+// without its newline is a torn write and is skipped on replay, as is a group
+// missing any of its records. Appends may come from several threads.
+class FleetJournal {
+public:
+    static const size_t SYNC_BATCH = 32;
+    static constexpr std::chrono::milliseconds SYNC_INTERVAL{2000};
+
+    ~FleetJournal() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        std::lock_guard<std::mutex> lock(mutex);
+        file_path = path;
+        file = fopen(path.c_str(), "ab");
+        last_sync = std::chrono::steady_clock::now();
+        return file != nullptr;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) return;
+        sync_locked();
+        fclose(file);
+        file = nullptr;
+    }
+
+    void append(const std::string& record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) return;
+        fwrite(record.data(), 1, record.size(), file);
+        fputc('\n', file);
+        fflush(file);
+        records++;
+        unsynced++;
+        if (unsynced >= SYNC_BATCH || std::chrono::steady_clock::now() - last_sync >= SYNC_INTERVAL) {
+            sync_locked();
+        }
+    }
+
+    // Appends `group` behind a G record in a single write
+    void append_group(const std::vector<std::string>& group) {
+        std::string block = "G " + std::to_string(group.size()) + "\n";
+        for (const std::string& record : group) block += record + "\n";
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) return;
+        fwrite(block.data(), 1, block.size(), file);
+        fflush(file);
+        records += group.size() + 1;
+        unsynced += group.size() + 1;
+        if (unsynced >= SYNC_BATCH || std::chrono::steady_clock::now() - last_sync >= SYNC_INTERVAL) {
+            sync_locked();
+        }
+    }
+
+    void sync() {
+        std::lock_guard<std::mutex> lock(mutex);
+        sync_locked();
+    }
+
+    // Empties the journal once its records have been folded into a snapshot
+    void truncate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (file) fclose(file);
+        file = fopen(file_path.c_str(), "wb");
+        if (file) sync_file(file);
+        records = 0;
+        unsynced = 0;
+    }
+
+    size_t record_count() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return records;
+    }
+
+    // Calls fn(op, args) for every complete record in the journal at `path`.
+    // A torn tail is cut off, so later appends do not run into it.
+    template <typename Fn>
+    size_t replay(const std::string& path, Fn fn) {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        size_t count = 0;
+        uintmax_t read = 0, complete = 0; // Bytes read, and up to the last complete record
+        std::vector<std::string> group;
+        while (std::getline(in, line)) {
+            if (in.eof()) break; // No trailing newline: torn write
+            read += line.size() + 1;
+            if (line.empty()) continue;
+            if (line[0] == 'G') {
+                size_t size = line.size() > 2 ? std::strtoul(line.c_str() + 2, nullptr, 10) : 0;
+                group.clear();
+                while (group.size() < size && std::getline(in, line) && !in.eof()) {
+                    read += line.size() + 1;
+                    group.push_back(line);
+                }
+                if (group.size() < size) break; // Torn group: none of it happened
+                for (const std::string& record : group) {
+                    if (!record.empty()) fn(record[0], record.size() > 2 ? record.substr(2) : std::string());
+                }
+                count += size + 1;
+                complete = read;
+                continue;
+            }
+            fn(line[0], line.size() > 2 ? line.substr(2) : std::string());
+            count++;
+            complete = read;
+        }
+        in.close();
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) > complete && !error) std::filesystem::resize_file(path, complete, error);
+        std::lock_guard<std::mutex> lock(mutex);
+        records = count;
+        return count;
+    }
+
+private:
+    void sync_locked() {
+        if (!file || unsynced == 0) return;
+        sync_file(file);
+        unsynced = 0;
+        last_sync = std::chrono::steady_clock::now();
+    }
+
+    mutable std::mutex mutex;
+    FILE* file = nullptr;
+    std::string file_path;
+    size_t records = 0;
+    size_t unsynced = 0;
+    std::chrono::steady_clock::time_point last_sync;
+};
+
+
+// --- Fast Loader ---
+
+// Read-only memory mapping of a whole file. An empty or missing file maps to
+// an empty view.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_handle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file_handle, &file_size);
+        length = static_cast<size_t>(file_size.QuadPart);
+        if (length == 0) return true;
+        map_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!map_handle) return false;
+        bytes = static_cast<const char*>(MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0));
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) return true;
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) return false;
+        bytes = static_cast<const char*>(mapping);
+#endif
+        return bytes != nullptr;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (map_handle) CloseHandle(map_handle);
+        if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+        map_handle = NULL;
+        file_handle = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    std::string_view view() const { return bytes ? std::string_view(bytes, length) : std::string_view(); }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE map_handle = NULL;
+#else
+    int fd = -1;
+#endif
+};
+
+// A line that could not be parsed while loading a data file
+struct LoadError {
+    std::string file;
+    size_t line;
+    std::string message;
+};
+
+// Splits off the next blank separated field
+std::string_view next_field(std::string_view& rest) {
+    size_t start = rest.find_first_not_of(" \t");
+    rest.remove_prefix(start == std::string_view::npos ? rest.size() : start);
+    size_t end = rest.find_first_of(" \t");
+    std::string_view field = rest.substr(0, end);
+    rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+    return field;
+}
+
+template <typename Number>
+bool parse_number(std::string_view text, Number& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Parses one line of car rental.txt / available.txt. Returns an error message or nullptr.
+const char* parse_car_line(std::string_view line, Car& car) {
+    std::string_view f[9];
+    for (auto& field : f) {
+        field = next_field(line);
+        if (field.empty()) return "expected 9 fields";
+    }
+    if (!next_field(line).empty()) return "too many fields";
+    if (!parse_number(f[3], car.capacity)) return "invalid capacity";
+    if (!parse_number(f[5], car.rate_per_hour) || !parse_number(f[6], car.rate_per_half) ||
+        !parse_number(f[7], car.rate_per_day)) {
+        return "invalid rate";
+    }
+    car.plate_num.assign(f[0]);
+    car.brand.assign(f[1]);
+    car.model.assign(f[2]);
+    car.colour.assign(f[4]);
+    car.transmission.assign(f[8]);
+    return nullptr;
+}
+
+// Splits an "id;name;phone;ic;address" line of Customer.txt into its fields
+// and parses the ID. Returns an error message or nullptr.
+const char* split_customer_line(std::string_view line, int& id, std::string_view (&f)[5]) {
+    for (size_t i = 0; i < 4; ++i) {
+        size_t end = line.find(';');
+        if (end == std::string_view::npos) return "expected 5 fields";
+        f[i] = line.substr(0, end);
+        line.remove_prefix(end + 1);
+    }
+    f[4] = line;
+    if (!parse_number(f[0], id)) return "invalid customer id";
+    return nullptr;
+}
+
+const char* parse_customer_line(std::string_view line, Customer& cust) {
+    std::string_view f[5];
+    if (const char* error = split_customer_line(line, cust.id, f)) return error;
+    cust.name.assign(f[1]);
+    cust.phone.assign(f[2]);
+    cust.ic.assign(f[3]);
+    cust.address.assign(f[4]);
+    return nullptr;
+}
+
+// Splits `text` into line aligned chunks and parses them on worker threads.
+// Records come back in file order; malformed lines are skipped and reported
+// in `errors` under `filename`.
+template <typename Record>
+std::vector<Record> parse_records_parallel(std::string_view text, const std::string& filename,
+                                           const char* (*parse)(std::string_view, Record&),
+                                           std::vector<LoadError>& errors) {
+    static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    struct Chunk {
+        std::string_view text;
+        std::vector<Record> records;
+        std::vector<std::pair<size_t, const char*>> errors; // Chunk-relative line number
+        size_t lines = 0;
+    };
+
+    std::vector<Record> records;
+    if (text.empty()) return records;
+
+    size_t workers = std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min<size_t>(workers, text.size() / MIN_CHUNK_BYTES + 1));
+
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    for (size_t i = 0; i < workers && begin < text.size(); ++i) {
+        size_t end = i + 1 == workers ? text.size() : begin + text.size() / workers;
+        end = end >= text.size() ? text.size() : text.find('\n', end);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        chunks.push_back(Chunk{text.substr(begin, end - begin), {}, {}, 0});
+        begin = end;
+    }
+
+    auto parse_chunk = [parse](Chunk& chunk) {
+        std::string_view rest = chunk.text;
+        Record record;
+        while (!rest.empty()) {
+            size_t end = rest.find('\n');
+            std::string_view line = rest.substr(0, end);
+            rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+            chunk.lines++;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+            if (const char* error = parse(line, record)) {
+                chunk.errors.emplace_back(chunk.lines, error);
+            } else {
+                chunk.records.push_back(record);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunks.size(); ++i) threads.emplace_back(parse_chunk, std::ref(chunks[i]));
+    parse_chunk(chunks[0]);
+    for (auto& t : threads) t.join();
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) total += chunk.records.size();
+    records.reserve(total);
+    size_t line_base = 0;
+    for (auto& chunk : chunks) {
+        for (auto& record : chunk.records) records.push_back(std::move(record));
+        for (const auto& error : chunk.errors) errors.push_back(LoadError{filename, line_base + error.first, error.second});
+        line_base += chunk.lines;
+    }
+    return records;
+}
+
+// Memory-maps `filename` and parses it with parse_records_parallel
+template <typename Record>
+std::vector<Record> load_records_parallel(const std::string& filename,
+                                          const char* (*parse)(std::string_view, Record&),
+                                          std::vector<LoadError>& errors) {
+    MappedFile file;
+    if (!file.open(filename)) return std::vector<Record>();
+    return parse_records_parallel(file.view(), filename, parse, errors);
+}
+
+
+// --- Binary Snapshot ---
+
+// fleet.snap layout. Every section starts on an 8 byte boundary:
+//   SnapshotHeader
+//   float    capacity[cars], rate_per_hour[cars], rate_per_half[cars], rate_per_day[cars]
+//   uint64_t available[(cars + 63) / 64]                  one bit per car in service
+//   int32_t  customer_id[customers]                      before version 5
+//   uint32_t string_offset[strings + 1]                   into the blob
+//   char     blob[blob_size]
+//   uint64_t reservation_count                            version 2 and later
+//   uint32_t reservation_car[n]                           index of the car above
+//   int64_t  reservation_start[n], reservation_end[n]
+//   int32_t  reservation_customer[n]
+//   uint64_t branch_count                                 version 3 and later
+//   uint32_t branch_offset[branch_count + 1]              into branch_names
+//   char     branch_names[branch_offset[branch_count]]
+//   uint32_t car_branch[cars]                             index of the car's branch
+//   uint64_t rental_count                                 version 4 and later
+//   uint32_t rental_car[n]                                index of the car above
+//   int64_t  rental_start[n], rental_due[n]
+//   int32_t  rental_customer[n]
+// Strings are stored per car as plate, brand, model, colour, transmission and,
+// before version 5, then per customer as name, phone, ic, address. Customers
+// now live in Customer.txt and its index, so version 5 writes none; the count
+// stays in the header so older snapshots can still be migrated.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t car_count;
+    uint32_t customer_count;    // 0 from version 5 on
+    uint32_t string_count;
+    uint64_t blob_size;
+    uint64_t checksum;      // FNV-1a of everything after the header
+};
+
+const char SNAPSHOT_MAGIC[8] = {'C', 'R', 'S', 'N', 'A', 'P', 0, 0};
+const uint32_t SNAPSHOT_VERSION = 5;
+
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t align8(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+// Writes the fleet to `path` through a temporary file
+bool write_snapshot(const std::string& path, const FleetStore& fleet) {
+    size_t car_count = fleet.size();
+    std::vector<float> capacity, rate_hour, rate_half, rate_day;
+    std::vector<uint64_t> available((car_count + 63) / 64, 0);
+    std::vector<uint32_t> offsets(1, 0);
+    std::vector<uint32_t> reservation_car;
+    std::vector<int64_t> reservation_start, reservation_end;
+    std::vector<int32_t> reservation_customer;
+    std::vector<uint32_t> branch_offsets(1, 0), car_branch;
+    std::vector<uint32_t> rental_car;
+    std::vector<int64_t> rental_start, rental_due;
+    std::vector<int32_t> rental_customer;
+    std::unordered_map<size_t, ActiveRental> rental_of;
+    for (const ActiveRental& rental : fleet.rentals()) rental_of.emplace(rental.slot, rental);
+    std::string blob, branch_names;
+    std::unordered_map<std::string_view, uint32_t> branch_index;
+    capacity.reserve(car_count);
+    rate_hour.reserve(car_count);
+    rate_half.reserve(car_count);
+    rate_day.reserve(car_count);
+    offsets.reserve(car_count * 5 + 1);
+
+    auto add_string = [&](std::string_view text) {
+        blob += text;
+        offsets.push_back(static_cast<uint32_t>(blob.size()));
+    };
+    fleet.for_each(false, [&](size_t slot, const CarView& car) {
+        size_t i = capacity.size();
+        if (fleet.in_service(slot)) available[i / 64] |= 1ULL << (i % 64);
+        capacity.push_back(car.capacity);
+        rate_hour.push_back(car.rate_per_hour);
+        rate_half.push_back(car.rate_per_half);
+        rate_day.push_back(car.rate_per_day);
+        add_string(car.plate_num);
+        add_string(car.brand);
+        add_string(car.model);
+        add_string(car.colour);
+        add_string(car.transmission);
+        auto branch = branch_index.emplace(car.branch, static_cast<uint32_t>(branch_index.size()));
+        if (branch.second) {
+            branch_names += car.branch;
+            branch_offsets.push_back(static_cast<uint32_t>(branch_names.size()));
+        }
+        car_branch.push_back(branch.first->second);
+        fleet.calendar(slot).for_each([&](const Reservation& reservation) {
+            reservation_car.push_back(static_cast<uint32_t>(i));
+            reservation_start.push_back(reservation.start);
+            reservation_end.push_back(reservation.end);
+            reservation_customer.push_back(reservation.customer_id);
+        });
+        auto rental = rental_of.find(slot);
+        if (rental != rental_of.end()) {
+            rental_car.push_back(static_cast<uint32_t>(i));
+            rental_start.push_back(rental->second.start);
+            rental_due.push_back(rental->second.due);
+            rental_customer.push_back(rental->second.customer_id);
+        }
+    });
+    if (blob.size() > UINT32_MAX) return false;
+
+    // Assemble the body so the checksum can be computed before writing
+    std::string body;
+    auto add_section = [&body](const void* data, size_t size) {
+        body.append(static_cast<const char*>(data), size);
+        body.resize(align8(body.size()), '\0');
+    };
+    add_section(capacity.data(), capacity.size() * sizeof(float));
+    add_section(rate_hour.data(), rate_hour.size() * sizeof(float));
+    add_section(rate_half.data(), rate_half.size() * sizeof(float));
+    add_section(rate_day.data(), rate_day.size() * sizeof(float));
+    add_section(available.data(), available.size() * sizeof(uint64_t));
+    add_section(offsets.data(), offsets.size() * sizeof(uint32_t));
+    add_section(blob.data(), blob.size());
+    uint64_t reservation_count = reservation_car.size();
+    add_section(&reservation_count, sizeof(reservation_count));
+    add_section(reservation_car.data(), reservation_car.size() * sizeof(uint32_t));
+    add_section(reservation_start.data(), reservation_start.size() * sizeof(int64_t));
+    add_section(reservation_end.data(), reservation_end.size() * sizeof(int64_t));
+    add_section(reservation_customer.data(), reservation_customer.size() * sizeof(int32_t));
+    uint64_t branch_count = branch_offsets.size() - 1;
+    add_section(&branch_count, sizeof(branch_count));
+    add_section(branch_offsets.data(), branch_offsets.size() * sizeof(uint32_t));
+    add_section(branch_names.data(), branch_names.size());
+    add_section(car_branch.data(), car_branch.size() * sizeof(uint32_t));
+    uint64_t rental_count = rental_car.size();
+    add_section(&rental_count, sizeof(rental_count));
+    add_section(rental_car.data(), rental_car.size() * sizeof(uint32_t));
+    add_section(rental_start.data(), rental_start.size() * sizeof(int64_t));
+    add_section(rental_due.data(), rental_due.size() * sizeof(int64_t));
+    add_section(rental_customer.data(), rental_customer.size() * sizeof(int32_t));
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.car_count = static_cast<uint32_t>(car_count);
+    header.customer_count = 0;
+    header.string_count = static_cast<uint32_t>(offsets.size() - 1);
+    header.blob_size = blob.size();
+    header.checksum = fnv1a(body.data(), body.size());
+
+    std::string temp_name = path + ".tmp";
+    FILE* file = fopen(temp_name.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(body.data(), 1, body.size(), file) == body.size();
+    sync_file(file);
+    fclose(file);
+    std::error_code ec;
+    if (ok) std::filesystem::rename(temp_name, path, ec);
+    return ok && !ec;
+}
+
+// True if `path` is a snapshot written by a newer version of the program,
+// which must be neither loaded nor overwritten
+bool snapshot_is_newer(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    SnapshotHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    return memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version > SNAPSHOT_VERSION;
+}
+
+// Maps a snapshot and, if it passes validation, replaces the fleet with its
+// contents. Snapshots before version 5 also fill `customers` so they can be
+// moved to Customer.txt. Returns nullptr on success or the reason it was rejected.
+const char* load_snapshot(const std::string& path, FleetStore& fleet, std::vector<Customer>& customers) {
+    MappedFile file;
+    if (!file.open(path)) return "cannot open snapshot";
+    std::string_view data = file.view();
+    if (data.size() < sizeof(SnapshotHeader)) return "snapshot is truncated";
+
+    SnapshotHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) return "not a snapshot file";
+    if (header.version < 1 || header.version > SNAPSHOT_VERSION) return "unsupported snapshot version";
+
+    size_t cars = header.car_count;
+    size_t custs = header.customer_count;
+    if (header.version >= 5 && custs != 0) return "snapshot customer count mismatch";
+    if (header.string_count != cars * 5 + custs * 4) return "snapshot string count mismatch";
+    size_t expected = sizeof(SnapshotHeader) + align8(cars * sizeof(float)) * 4 +
+                      align8((cars + 63) / 64 * sizeof(uint64_t)) + align8(custs * sizeof(int32_t)) +
+                      align8((header.string_count + 1) * sizeof(uint32_t)) + align8(header.blob_size);
+    uint64_t reservations = 0;
+    if (header.version >= 2) {
+        if (data.size() < expected + sizeof(uint64_t)) return "snapshot is truncated";
+        memcpy(&reservations, data.data() + expected, sizeof(reservations));
+        if (reservations > data.size()) return "snapshot size mismatch";
+        expected += sizeof(uint64_t) + align8(reservations * sizeof(uint32_t)) + align8(reservations * sizeof(int64_t)) * 2 +
+                    align8(reservations * sizeof(int32_t));
+    }
+    uint64_t branches = 0;
+    uint32_t branch_bytes = 0;
+    if (header.version >= 3) {
+        if (data.size() < expected + sizeof(uint64_t)) return "snapshot is truncated";
+        memcpy(&branches, data.data() + expected, sizeof(branches));
+        if (branches > cars || data.size() < expected + sizeof(uint64_t) + (branches + 1) * sizeof(uint32_t)) {
+            return "snapshot size mismatch";
+        }
+        memcpy(&branch_bytes, data.data() + expected + sizeof(uint64_t) + branches * sizeof(uint32_t), sizeof(branch_bytes));
+        expected += sizeof(uint64_t) + align8((branches + 1) * sizeof(uint32_t)) + align8(branch_bytes) +
+                    align8(cars * sizeof(uint32_t));
+    }
+    uint64_t rentals = 0;
+    if (header.version >= 4) {
+        if (data.size() < expected + sizeof(uint64_t)) return "snapshot is truncated";
+        memcpy(&rentals, data.data() + expected, sizeof(rentals));
+        if (rentals > cars) return "snapshot size mismatch";
+        expected += sizeof(uint64_t) + align8(rentals * sizeof(uint32_t)) + align8(rentals * sizeof(int64_t)) * 2 +
+                    align8(rentals * sizeof(int32_t));
+    }
+    if (data.size() != expected) return "snapshot size mismatch";
+    const char* body = data.data() + sizeof(SnapshotHeader);
+    if (fnv1a(body, data.size() - sizeof(SnapshotHeader)) != header.checksum) return "snapshot checksum mismatch";
+
+    const char* cursor = body;
+    auto take = [&cursor](size_t size) {
+        const char* section = cursor;
+        cursor += align8(size);
+        return section;
+    };
+    const float* capacity = reinterpret_cast<const float*>(take(cars * sizeof(float)));
+    const float* rate_hour = reinterpret_cast<const float*>(take(cars * sizeof(float)));
+    const float* rate_half = reinterpret_cast<const float*>(take(cars * sizeof(float)));
+    const float* rate_day = reinterpret_cast<const float*>(take(cars * sizeof(float)));
+    const uint64_t* available = reinterpret_cast<const uint64_t*>(take((cars + 63) / 64 * sizeof(uint64_t)));
+    const int32_t* customer_id = reinterpret_cast<const int32_t*>(take(custs * sizeof(int32_t)));
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(take((header.string_count + 1) * sizeof(uint32_t)));
+    const char* blob = take(header.blob_size);
+    take(header.version >= 2 ? sizeof(uint64_t) : 0);
+    const uint32_t* reservation_car = reinterpret_cast<const uint32_t*>(take(reservations * sizeof(uint32_t)));
+    const int64_t* reservation_start = reinterpret_cast<const int64_t*>(take(reservations * sizeof(int64_t)));
+    const int64_t* reservation_end = reinterpret_cast<const int64_t*>(take(reservations * sizeof(int64_t)));
+    const int32_t* reservation_customer = reinterpret_cast<const int32_t*>(take(reservations * sizeof(int32_t)));
+    take(header.version >= 3 ? sizeof(uint64_t) : 0);
+    const uint32_t* branch_offsets = reinterpret_cast<const uint32_t*>(take(header.version >= 3 ? (branches + 1) * sizeof(uint32_t) : 0));
+    const char* branch_names = take(branch_bytes);
+    const uint32_t* car_branch = reinterpret_cast<const uint32_t*>(take(header.version >= 3 ? cars * sizeof(uint32_t) : 0));
+    take(header.version >= 4 ? sizeof(uint64_t) : 0);
+    const uint32_t* rental_car = reinterpret_cast<const uint32_t*>(take(rentals * sizeof(uint32_t)));
+    const int64_t* rental_start = reinterpret_cast<const int64_t*>(take(rentals * sizeof(int64_t)));
+    const int64_t* rental_due = reinterpret_cast<const int64_t*>(take(rentals * sizeof(int64_t)));
+    const int32_t* rental_customer = reinterpret_cast<const int32_t*>(take(rentals * sizeof(int32_t)));
+
+    if (offsets[0] != 0 || offsets[header.string_count] != header.blob_size) return "snapshot string table is corrupt";
+    for (size_t i = 0; i < header.string_count; ++i) {
+        if (offsets[i] > offsets[i + 1]) return "snapshot string table is corrupt";
+    }
+
+    size_t next_string = 0;
+    auto string_at = [&](std::string& out) {
+        out.assign(blob + offsets[next_string], offsets[next_string + 1] - offsets[next_string]);
+        next_string++;
+    };
+    for (size_t i = 0; i < reservations; ++i) {
+        if (reservation_car[i] >= cars) return "snapshot reservation table is corrupt";
+    }
+    for (size_t i = 0; i < rentals; ++i) {
+        if (rental_car[i] >= cars) return "snapshot rental table is corrupt";
+    }
+    std::vector<std::string_view> branch_of;
+    if (header.version >= 3) {
+        if (branch_offsets[0] != 0) return "snapshot branch table is corrupt";
+        for (size_t i = 0; i < branches; ++i) {
+            if (branch_offsets[i] > branch_offsets[i + 1]) return "snapshot branch table is corrupt";
+            branch_of.emplace_back(branch_names + branch_offsets[i], branch_offsets[i + 1] - branch_offsets[i]);
+        }
+        for (size_t i = 0; i < cars; ++i) {
+            if (car_branch[i] >= branches) return "snapshot branch table is corrupt";
+        }
+    }
+
+    fleet.clear();
+    std::vector<size_t> slots(cars);
+    Car car;
+    for (size_t i = 0; i < cars; ++i) {
+        string_at(car.plate_num);
+        string_at(car.brand);
+        string_at(car.model);
+        string_at(car.colour);
+        string_at(car.transmission);
+        car.capacity = capacity[i];
+        car.rate_per_hour = rate_hour[i];
+        car.rate_per_half = rate_half[i];
+        car.rate_per_day = rate_day[i];
+        slots[i] = fleet.add(car, (available[i / 64] >> (i % 64)) & 1,
+                             header.version >= 3 ? branch_of[car_branch[i]] : std::string_view(MAIN_BRANCH));
+    }
+    for (size_t i = 0; i < reservations; ++i) {
+        if (slots[reservation_car[i]] == FleetStore::npos) continue;
+        fleet.calendar(slots[reservation_car[i]])
+            .book(Reservation{static_cast<time_t>(reservation_start[i]), static_cast<time_t>(reservation_end[i]),
+                              reservation_customer[i]});
+    }
+    for (size_t i = 0; i < rentals; ++i) {
+        if (slots[rental_car[i]] == FleetStore::npos) continue;
+        fleet.restore_rental(slots[rental_car[i]], Reservation{static_cast<time_t>(rental_start[i]),
+                                                               static_cast<time_t>(rental_due[i]), rental_customer[i]});
+    }
+    customers.assign(custs, Customer());
+    for (size_t i = 0; i < custs; ++i) {
+        customers[i].id = customer_id[i];
+        string_at(customers[i].name);
+        string_at(customers[i].phone);
+        string_at(customers[i].ic);
+        string_at(customers[i].address);
+    }
+    return nullptr;
+}
+
+
+// --- Text File Sync ---
+
+// Modification time and size of a file, to tell our own writes from other edits
+struct FileStamp {
+    bool exists = false;
+    long long mtime = 0;
+    uintmax_t size = 0;
+
+    bool operator==(const FileStamp& other) const {
+        return exists == other.exists && mtime == other.mtime && size == other.size;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+FileStamp file_stamp(const std::string& path) {
+    FileStamp stamp;
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return stamp;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) return stamp;
+    stamp.exists = true;
+    stamp.mtime = static_cast<long long>(mtime.time_since_epoch().count());
+    stamp.size = size;
+    return stamp;
+}
+
+// One hash pair per record of a text file: the record's key (plate or
+// customer ID) and its full contents. Comparing the fingerprint of the version
+// we last wrote with the one on disk gives the records another program added,
+// changed or removed, without keeping a copy of the file.
+class Fingerprint {
+public:
+    struct Entry {
+        uint64_t key;
+        uint64_t hash;
+        uint32_t index;   // Position of the record in the list it was built from
+    };
+
+    void add(uint64_t key, uint64_t hash, size_t index) {
+        entries.push_back(Entry{key, hash, static_cast<uint32_t>(index)});
+        sorted = false;
+    }
+
+    void clear() {
+        entries.clear();
+        sorted = true;
+    }
+
+    // Adds or replaces the entry for `key`
+    void set(uint64_t key, uint64_t hash) {
+        seal();
+        auto it = lower(key);
+        if (it != entries.end() && it->key == key) it->hash = hash;
+        else entries.insert(it, Entry{key, hash, 0});
+    }
+
+    // Sorts by key; of several records with one key only the first counts
+    void seal() {
+        if (sorted) return;
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key == b.key; }),
+                      entries.end());
+        sorted = true;
+    }
+
+    // Records of `current` that are new or changed since this fingerprint, and
+    // the keys that are gone. Both fingerprints must be sealed.
+    void diff(const Fingerprint& current, std::vector<uint32_t>& changed, std::vector<uint64_t>& removed) const {
+        auto old_it = entries.begin();
+        auto new_it = current.entries.begin();
+        while (old_it != entries.end() || new_it != current.entries.end()) {
+            if (new_it == current.entries.end() || (old_it != entries.end() && old_it->key < new_it->key)) {
+                removed.push_back((old_it++)->key);
+            } else if (old_it == entries.end() || new_it->key < old_it->key) {
+                changed.push_back((new_it++)->index);
+            } else {
+                if (old_it->hash != new_it->hash) changed.push_back(new_it->index);
+                ++old_it;
+                ++new_it;
+            }
+        }
+    }
+
+private:
+    std::vector<Entry> entries;
+    bool sorted = true;
+
+    std::vector<Entry>::iterator lower(uint64_t key) {
+        return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, uint64_t k) { return e.key < k; });
+    }
+};
+
+uint64_t record_key(std::string_view plate) { return fnv1a(plate.data(), plate.size()); }
+uint64_t record_key(int customer_id) { return static_cast<uint64_t>(static_cast<uint32_t>(customer_id)); }
+
+// Hash of a record as write_car_record/write_customer_record formats it, so
+// edits that only change spacing or number formatting are not differences
+template <typename Record, typename Write>
+uint64_t record_hash(const Record& record, Write write) {
+    std::ostringstream text;
+    write(text, record);
+    std::string formatted = text.str();
+    return fnv1a(formatted.data(), formatted.size());
+}
+
+// Wakes up when files with the given names, or subdirectories, may have
+// changed in the watched directories. Uses inotify on Linux; elsewhere every
+// wait simply times out and reports a possible change, so callers poll the
+// file stamps.
+class FileWatcher {
+public:
+    explicit FileWatcher(std::vector<std::string> names) : names(std::move(names)) {
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0 && inotify_add_watch(fd, ".", WATCH_EVENTS) < 0) {
+            ::close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    // Adds a directory. Directories that do not exist yet can be added again later.
+    void watch(const std::string& dir) {
+#ifdef __linux__
+        if (fd < 0 || !watched.insert(dir).second) return;
+        if (inotify_add_watch(fd, dir.c_str(), WATCH_EVENTS) < 0) watched.erase(dir);
+#else
+        (void)dir;
+#endif
+    }
+
+    ~FileWatcher() {
+#ifdef __linux__
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Waits up to `timeout`. Returns true if one of the watched files may
+    // have changed.
+    bool wait(std::chrono::milliseconds timeout) {
+#ifdef __linux__
+        if (fd >= 0) {
+            pollfd waiting{fd, POLLIN, 0};
+            if (poll(&waiting, 1, static_cast<int>(timeout.count())) <= 0) return false;
+            bool relevant = false;
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* at = buffer; at < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(at);
+                    if (event->len > 0 && ((event->mask & IN_ISDIR) ||
+                                           std::find(names.begin(), names.end(), event->name) != names.end())) {
+                        relevant = true;
+                    }
+                    at += sizeof(inotify_event) + event->len;
+                }
+            }
+            return relevant;
+        }
+#endif
+        std::this_thread::sleep_for(timeout);
+        return true;
+    }
+
+private:
+    std::vector<std::string> names;
+#ifdef __linux__
+    static const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_CREATE;
+    int fd = -1;
+    std::set<std::string> watched{"."};
+#endif
+};
+
+// Branches other than the main one keep their car rental.txt and available.txt
+// in branches/<name>/; the main branch's files stay in the working directory.
+const std::string BRANCH_ROOT = "branches";
+
+bool valid_branch_name(std::string_view name) {
+    if (name.empty() || name.size() > 32) return false;
+    for (char c : name) {
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') return false;
+    }
+    return true;
+}
+
+std::string branch_path(std::string_view branch, const char* file) {
+    if (branch == MAIN_BRANCH) return file;
+    return BRANCH_ROOT + "/" + std::string(branch) + "/" + file;
+}
+
+// Names of the branch directories, sorted
+std::vector<std::string> branch_directories() {
+    std::vector<std::string> found;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(BRANCH_ROOT, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (it->is_directory(ec) && valid_branch_name(name) && name != MAIN_BRANCH) found.push_back(name);
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+
+// --- Customer Store ---
+
+// Customer.txt is the customer store itself: new customers are appended to it
+// and it is never rewritten. Customer.idx is built from it once and kept next
+// to it. It holds the byte offset of every customer's line, sorted by ID, and
+// the sorted name, phone and IC arrays for prefix search, with the same 8 byte
+// heads as PrefixIndex. Only the index is mapped; the records themselves are
+// read when asked for and kept in a small LRU cache.
+//
+// Layout of Customer.idx (native byte order):
+//   CustomerIndexHeader
+//   CustomerIndexEntry entry[count]        sorted by ID
+//   uint64_t head[3][count]                name, phone and IC heads, each in key order
+//   uint32_t row[3][count]                 the entry each head belongs to
+struct CustomerIndexHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t max_id;
+    uint64_t count;
+    uint64_t text_size;         // Bytes of Customer.txt covered, always whole lines
+    uint64_t tail_hash;         // fnv1a of the last covered bytes; see CustomerStore
+    uint64_t text_lines;        // Lines in the covered bytes, for numbering later ones
+};
+
+struct CustomerIndexEntry {
+    int32_t id;
+    uint32_t length;            // Of the line, without the line break
+    uint64_t offset;
+};
+
+const char CUSTOMER_INDEX_MAGIC[8] = {'C', 'R', 'C', 'I', 'D', 'X', 0, 0};
+const uint32_t CUSTOMER_INDEX_VERSION = 2;
+const size_t CUSTOMER_FIELD_COUNT = 3;
+
+// Bytes at the end of the indexed part of Customer.txt that are compared to
+// tell an append from a rewrite
+const size_t TAIL_CHECK_BYTES = 4096;
+
+uint64_t tail_hash(std::string_view text, uint64_t size) {
+    size_t from = size > TAIL_CHECK_BYTES ? size - TAIL_CHECK_BYTES : 0;
+    return fnv1a(text.data() + from, size - from);
+}
+
+// A customer line while Customer.idx is being built. `line` points into the
+// mapped Customer.txt.
+struct CustomerRow {
+    std::string_view line;
+    int id;
+    uint64_t head[CUSTOMER_FIELD_COUNT];
+
+    std::string_view key(CustomerField field) const {
+        int unused;
+        std::string_view f[5];
+        split_customer_line(line, unused, f);
+        return f[1 + static_cast<size_t>(field)];
+    }
+};
+
+const char* parse_customer_row(std::string_view line, CustomerRow& row) {
+    std::string_view f[5];
+    if (const char* error = split_customer_line(line, row.id, f)) return error;
+    row.line = line;
+    for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field) row.head[field] = PrefixIndex::head(f[1 + field]);
+    return nullptr;
+}
+
+// Writes the index of the whole lines of `text_path` to `index_path`. Lines
+// that cannot be parsed, and repeats of an ID (the first line wins), are
+// reported in `errors`. Returns false if the index could not be written.
+bool build_customer_index(const std::string& text_path, const std::string& index_path, std::vector<LoadError>& errors) {
+    MappedFile text_file;
+    text_file.open(text_path);
+    std::string_view text = text_file.view();
+    size_t covered = text.rfind('\n');
+    covered = covered == std::string_view::npos ? 0 : covered + 1;
+
+    std::vector<CustomerRow> rows = parse_records_parallel(text.substr(0, covered), text_path, parse_customer_row, errors);
+    std::stable_sort(rows.begin(), rows.end(), [](const CustomerRow& a, const CustomerRow& b) { return a.id < b.id; });
+    auto repeated = std::unique(rows.begin(), rows.end(), [](const CustomerRow& a, const CustomerRow& b) { return a.id == b.id; });
+    for (auto it = repeated; it != rows.end(); ++it) {
+        errors.push_back(LoadError{text_path, 0, "duplicate customer id " + std::to_string(it->id)});
+    }
+    rows.erase(repeated, rows.end());
+
+    // The three sorts are independent, so large files run them side by side
+    std::vector<uint32_t> order[CUSTOMER_FIELD_COUNT];
+    auto sort_field = [&rows, &order](size_t field) {
+        std::vector<uint32_t>& sorted = order[field];
+        sorted.resize(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) sorted[i] = static_cast<uint32_t>(i);
+        std::sort(sorted.begin(), sorted.end(), [&rows, field](uint32_t a, uint32_t b) {
+            if (rows[a].head[field] != rows[b].head[field]) return rows[a].head[field] < rows[b].head[field];
+            CustomerField which = static_cast<CustomerField>(field);
+            int compared = PrefixIndex::compare_folded(rows[a].key(which), rows[b].key(which));
+            return compared != 0 ? compared < 0 : a < b;
+        });
+    };
+    if (rows.size() < 100000) {
+        for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field) sort_field(field);
+    } else {
+        std::thread name(sort_field, 0);
+        std::thread phone(sort_field, 1);
+        sort_field(2);
+        name.join();
+        phone.join();
+    }
+
+    CustomerIndexHeader header;
+    memcpy(header.magic, CUSTOMER_INDEX_MAGIC, sizeof(header.magic));
+    header.version = CUSTOMER_INDEX_VERSION;
+    header.max_id = rows.empty() ? 0 : rows.back().id;
+    header.count = rows.size();
+    header.text_size = covered;
+    header.tail_hash = tail_hash(text, covered);
+    header.text_lines = static_cast<uint64_t>(std::count(text.begin(), text.begin() + covered, '\n'));
+
+    std::ofstream out(index_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<char> buffer;
+    auto write_column = [&](size_t bytes_per_row, auto fill) {
+        static const size_t BATCH = 1 << 16;
+        for (size_t start = 0; start < rows.size(); start += BATCH) {
+            size_t end = std::min(rows.size(), start + BATCH);
+            buffer.resize((end - start) * bytes_per_row);
+            for (size_t i = start; i < end; ++i) fill(i, buffer.data() + (i - start) * bytes_per_row);
+            out.write(buffer.data(), buffer.size());
+        }
+    };
+    write_column(sizeof(CustomerIndexEntry), [&](size_t i, char* at) {
+        CustomerIndexEntry entry{rows[i].id, static_cast<uint32_t>(rows[i].line.size()),
+                                 static_cast<uint64_t>(rows[i].line.data() - text.data())};
+        memcpy(at, &entry, sizeof(entry));
+    });
+    for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field) {
+        write_column(sizeof(uint64_t), [&](size_t i, char* at) { memcpy(at, &rows[order[field][i]].head[field], sizeof(uint64_t)); });
+    }
+    for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field) {
+        write_column(sizeof(uint32_t), [&](size_t i, char* at) { memcpy(at, &order[field][i], sizeof(uint32_t)); });
+    }
+    out.close();
+    return static_cast<bool>(out);
+}
+
+// A mapped Customer.idx
+class CustomerIndex {
+public:
+    // Returns an error message, or nullptr once the file is mapped
+    const char* open(const std::string& path) {
+        close();
+        if (!file.open(path)) return "cannot open customer index";
+        std::string_view data = file.view();
+        if (data.size() < sizeof(CustomerIndexHeader)) return "customer index is truncated";
+        header = reinterpret_cast<const CustomerIndexHeader*>(data.data());
+        if (memcmp(header->magic, CUSTOMER_INDEX_MAGIC, sizeof(header->magic)) != 0) return "not a customer index";
+        if (header->version != CUSTOMER_INDEX_VERSION) return "unsupported customer index version";
+        uint64_t count = header->count;
+        if (count > (data.size() - sizeof(CustomerIndexHeader)) / sizeof(CustomerIndexEntry) ||
+            data.size() != sizeof(CustomerIndexHeader) + count * (sizeof(CustomerIndexEntry) +
+                                                                  CUSTOMER_FIELD_COUNT * (sizeof(uint64_t) + sizeof(uint32_t)))) {
+            return "customer index size mismatch";
+        }
+        const char* at = data.data() + sizeof(CustomerIndexHeader);
+        entries = reinterpret_cast<const CustomerIndexEntry*>(at);
+        at += count * sizeof(CustomerIndexEntry);
+        for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field, at += count * sizeof(uint64_t)) {
+            heads[field] = reinterpret_cast<const uint64_t*>(at);
+        }
+        for (size_t field = 0; field < CUSTOMER_FIELD_COUNT; ++field, at += count * sizeof(uint32_t)) {
+            rows[field] = reinterpret_cast<const uint32_t*>(at);
+        }
+        ready = true;
+        return nullptr;
+    }
+
+    void close() {
+        file.close();
+        ready = false;
+    }
+
+    size_t size() const { return ready ? static_cast<size_t>(header->count) : 0; }
+    int max_id() const { return ready ? header->max_id : 0; }
+    uint64_t text_size() const { return ready ? header->text_size : 0; }
+    uint64_t text_tail_hash() const { return ready ? header->tail_hash : 0; }
+    uint64_t text_lines() const { return ready ? header->text_lines : 0; }
+
+    const CustomerIndexEntry* find(int id) const {
+        const CustomerIndexEntry* end = entries + size();
+        const CustomerIndexEntry* it = std::lower_bound(entries, end, id, [](const CustomerIndexEntry& entry, int wanted) {
+            return entry.id < wanted;
+        });
+        return it != end && it->id == id ? it : nullptr;
+    }
+
+    const CustomerIndexEntry& entry(uint32_t row) const { return entries[row]; }
+
+    // Appends up to `limit` rows whose field starts with `prefix` (ignoring
+    // ASCII case), in key order. `key_of(row)` reads a full key; it is only
+    // needed when the prefix is longer than a head.
+    template <typename KeyOf>
+    void search(CustomerField field, std::string_view prefix, size_t limit, KeyOf key_of, std::vector<uint32_t>& out) const {
+        size_t count = size();
+        if (count == 0) return;
+        const uint64_t* head = heads[static_cast<size_t>(field)];
+        const uint32_t* row = rows[static_cast<size_t>(field)];
+        uint64_t prefix_head = PrefixIndex::head(prefix);
+        // Keys whose head equals a short prefix's head are the prefix itself
+        auto below = [&](size_t k) {
+            if (head[k] != prefix_head) return head[k] < prefix_head;
+            return prefix.size() > 8 && PrefixIndex::compare_folded(key_of(row[k]), prefix) < 0;
+        };
+        uint64_t mask = prefix.size() >= 8 ? ~uint64_t(0) : prefix.empty() ? 0 : ~uint64_t(0) << (8 * (8 - prefix.size()));
+        auto matches = [&](size_t k) {
+            if ((head[k] & mask) != (prefix_head & mask)) return false;
+            if (prefix.size() <= 8) return true;
+            std::string key = key_of(row[k]);
+            return key.size() >= prefix.size() && PrefixIndex::compare_folded(std::string_view(key).substr(0, prefix.size()), prefix) == 0;
+        };
+        size_t low = 0, high = count;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (below(mid)) low = mid + 1;
+            else high = mid;
+        }
+        for (size_t k = low; k < count && out.size() < limit && matches(k); ++k) out.push_back(row[k]);
+    }
+
+private:
+    MappedFile file;
+    bool ready = false;
+    const CustomerIndexHeader* header = nullptr;
+    const CustomerIndexEntry* entries = nullptr;
+    const uint64_t* heads[CUSTOMER_FIELD_COUNT] = {};
+    const uint32_t* rows[CUSTOMER_FIELD_COUNT] = {};
+};
+
+// All customers, with about the same memory use whatever their number: the
+// mapped Customer.idx, an LRU cache of recently used records, and a
+// CustomerDirectory of the customers added to Customer.txt since the index
+// was built. That directory is folded into a fresh index once it passes
+// REBUILD_AFTER customers. Startup maps the index
+// and parses only the lines after the part it covers.
+//
+// Threading: RentalSystem guards it with data_mutex; find, search and the
+// other const methods are safe under a shared lock (the cache and the reader
+// have their own lock). build_index only reads Customer.txt as it was when it
+// started, so it runs without data_mutex; adopt_index swaps it in under an
+// exclusive lock.
+class CustomerStore {
+public:
+    static const size_t CACHE_CAPACITY = 4096;
+    static const size_t REBUILD_AFTER = 65536;
+
+    enum class Change { NONE, APPENDED, REWRITTEN };
+
+    explicit CustomerStore(std::string text_path = "Customer.txt", size_t cache_capacity = CACHE_CAPACITY)
+        : text_path(std::move(text_path)), index_path(this->text_path.substr(0, this->text_path.rfind('.')) + ".idx"),
+          cache_capacity(cache_capacity) {}
+
+    // Maps Customer.idx, building it first if it is missing, if `rebuild` is
+    // set, or if Customer.txt no longer starts with the text it covers. Then
+    // reads the customers after that part.
+    void open(std::vector<LoadError>& errors, bool rebuild = false) {
+        close();
+        if (rebuild || index.open(index_path) || !covers_text()) {
+            index.close();
+            std::string temp_name = index_path + ".tmp";
+            if (build_customer_index(text_path, temp_name, errors)) {
+                std::error_code ec;
+                std::filesystem::rename(temp_name, index_path, ec);
+            }
+            if (const char* error = index.open(index_path)) errors.push_back(LoadError{index_path, 0, error});
+        }
+        reader.open(text_path, std::ios::binary);
+        std::lock_guard<std::mutex> lock(append_mutex);
+        known_size = index.text_size();
+        known_lines = index.text_lines();
+        read_text(known_size - std::min<uint64_t>(known_size, TAIL_CHECK_BYTES), known_size, known_tail);
+        read_appended_locked(errors);
+    }
+
+    void close() {
+        write_pending();
+        {
+            std::lock_guard<std::mutex> lock(append_mutex);
+            if (appender) fclose(appender);
+            appender = nullptr;
+        }
+        if (reader.is_open()) reader.close();
+        index.close();
+        recent.assign({});
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        lru.clear();
+        cached.clear();
+    }
+
+    size_t size() const { return index.size() + recent.size(); }
+    int next_id() const { return std::max(recent.next_id(), index.max_id() + 1); }
+
+    // Customers held in memory: the recent ones plus the cache
+    size_t resident() const {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        return recent.size() + lru.size();
+    }
+
+    bool find(int id, Customer& out) const {
+        if (const Customer* cust = recent.find(id)) {
+            out = *cust;
+            return true;
+        }
+        const CustomerIndexEntry* entry = index.find(id);
+        return entry && load(*entry, out);
+    }
+
+    // Up to `limit` customers whose field starts with `prefix`, ignoring case,
+    // sorted by that field
+    std::vector<Customer> search(CustomerField field, std::string_view prefix, size_t limit) const {
+        std::vector<uint32_t> rows;
+        index.search(field, prefix, limit, [&](uint32_t row) {
+            Customer cust;
+            load(index.entry(row), cust);
+            return std::string(PrefixIndex::key(cust, field));
+        }, rows);
+        std::vector<Customer> indexed(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) load(index.entry(rows[i]), indexed[i]);
+        std::vector<const Customer*> added = recent.search(field, prefix, limit);
+
+        std::vector<Customer> found;
+        size_t a = 0, b = 0;
+        while (found.size() < limit && (a < indexed.size() || b < added.size())) {
+            bool take_indexed = b == added.size() ||
+                                (a < indexed.size() && PrefixIndex::compare_folded(PrefixIndex::key(*added[b], field),
+                                                                                   PrefixIndex::key(indexed[a], field)) >= 0);
+            found.push_back(take_indexed ? indexed[a++] : *added[b++]);
+        }
+        return found;
+    }
+
+    // Gives the customer the next free ID and returns it. The customer can be
+    // found at once, but is only queued for Customer.txt: call write_pending
+    // once the lock that serializes changes to the store is released, so
+    // other threads do not wait on the disk.
+    int add(Customer cust) {
+        cust.id = next_id();
+        queue(cust);
+        return cust.id;
+    }
+
+    // Queues a customer that already has an ID, like add. Returns false if the
+    // ID is taken.
+    bool insert(const Customer& cust) { return queue(cust); }
+
+    // Appends the queued customers to Customer.txt, in the order they were
+    // added, and syncs it, so an ID handed out after this returns survives a
+    // crash. Safe to call while other threads read the store.
+    void write_pending() {
+        std::lock_guard<std::mutex> lock(append_mutex);
+        if (pending.empty()) return;
+        std::string text;
+        if (known_size > 0 && known_tail.back() != '\n') text = "\n";
+        for (const std::string& record : pending) text += record;
+        pending.clear();
+        if (!appender) appender = fopen(text_path.c_str(), "ab");
+        if (appender) {
+            fwrite(text.data(), 1, text.size(), appender);
+            sync_file(appender);
+        }
+        note_text(text);
+    }
+
+    // How Customer.txt changed since this store last read or wrote it
+    Change external_change() const {
+        std::lock_guard<std::mutex> lock(append_mutex);
+        FileStamp now = file_stamp(text_path);
+        if (now == known_stamp) return Change::NONE;
+        if (!now.exists || now.size < known_size) return Change::REWRITTEN;
+        std::string tail;
+        read_text(known_size - known_tail.size(), known_size, tail);
+        return tail == known_tail ? Change::APPENDED : Change::REWRITTEN;
+    }
+
+    // Reads the customers appended after what this store has seen. IDs that
+    // are already taken are reported and skipped.
+    void read_appended(std::vector<LoadError>& errors) {
+        std::lock_guard<std::mutex> lock(append_mutex);
+        read_appended_locked(errors);
+    }
+
+    bool needs_rebuild() const { return recent.size() > REBUILD_AFTER; }
+
+    // Writes a fresh index to Customer.idx.tmp for adopt_index
+    bool build_index(std::vector<LoadError>& errors) const {
+        return build_customer_index(text_path, index_path + ".tmp", errors);
+    }
+
+    // Replaces the index with the one build_index wrote and rereads whatever
+    // it does not cover
+    void adopt_index(std::vector<LoadError>& errors) {
+        close();
+        std::error_code ec;
+        std::filesystem::rename(index_path + ".tmp", index_path, ec);
+        open(errors);
+    }
+
+private:
+    void read_appended_locked(std::vector<LoadError>& errors) {
+        FileStamp now = file_stamp(text_path);
+        std::string text;
+        if (now.exists && now.size > known_size) read_text(known_size, now.size, text);
+        std::vector<LoadError> parse_errors;
+        for (const Customer& cust : parse_records_parallel<Customer>(text, text_path, parse_customer_line, parse_errors)) {
+            Customer existing;
+            if (!find(cust.id, existing)) recent.insert(cust);
+            else errors.push_back(LoadError{text_path, 0, "duplicate customer id " + std::to_string(cust.id)});
+        }
+        // Line numbers are relative to the appended text
+        for (auto& error : parse_errors) error.line += known_lines;
+        errors.insert(errors.end(), parse_errors.begin(), parse_errors.end());
+        note_text(text);
+        known_stamp = now;
+    }
+
+    std::string text_path;
+    std::string index_path;
+    size_t cache_capacity;
+    CustomerIndex index;
+    CustomerDirectory recent;                  // Customers after the indexed part
+
+    mutable std::mutex append_mutex;           // Guards the appender, the queue and what is known of the file
+    FILE* appender = nullptr;
+    std::vector<std::string> pending;          // Records added but not yet written
+    uint64_t known_size = 0;                   // Bytes of Customer.txt read or written so far
+    std::string known_tail;                    // Their last TAIL_CHECK_BYTES
+    uint64_t known_lines = 0;                  // Lines in them
+    FileStamp known_stamp;
+
+    mutable std::mutex cache_mutex;            // Guards the cache and the reader
+    mutable std::ifstream reader;
+    mutable std::list<Customer> lru;           // Most recently used first
+    mutable std::unordered_map<int, std::list<Customer>::iterator> cached;
+
+    // True if Customer.txt still starts with the text the index covers
+    bool covers_text() {
+        FileStamp now = file_stamp(text_path);
+        uint64_t size = index.text_size();
+        if ((now.exists ? now.size : 0) < size) return false;
+        std::ifstream text(text_path, std::ios::binary);
+        std::string tail(static_cast<size_t>(std::min<uint64_t>(size, TAIL_CHECK_BYTES)), '\0');
+        text.seekg(static_cast<std::streamoff>(size - tail.size()));
+        text.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+        return text && tail_hash(tail, tail.size()) == index.text_tail_hash();
+    }
+
+    void read_text(uint64_t from, uint64_t to, std::string& out) const {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        out.assign(static_cast<size_t>(to - from), '\0');
+        reader.clear();
+        reader.seekg(static_cast<std::streamoff>(from));
+        reader.read(&out[0], static_cast<std::streamsize>(out.size()));
+        out.resize(static_cast<size_t>(reader.gcount()));
+    }
+
+    // Makes the customer findable and queues its record. False if the ID is taken.
+    bool queue(const Customer& cust) {
+        Customer existing;
+        if (find(cust.id, existing)) return false;
+        std::ostringstream record;
+        write_customer_record(record, cust);
+        record << "\n";
+        recent.insert(cust);
+        std::lock_guard<std::mutex> lock(append_mutex);
+        pending.push_back(record.str());
+        return true;
+    }
+
+    void note_text(const std::string& text) {
+        known_size += text.size();
+        known_lines += static_cast<uint64_t>(std::count(text.begin(), text.end(), '\n'));
+        known_tail += text;
+        if (known_tail.size() > TAIL_CHECK_BYTES) known_tail.erase(0, known_tail.size() - TAIL_CHECK_BYTES);
+        known_stamp = file_stamp(text_path);
+    }
+
+    // Reads an indexed customer through the cache
+    bool load(const CustomerIndexEntry& entry, Customer& out) const {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = cached.find(entry.id);
+        if (it != cached.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            out = *it->second;
+            return true;
+        }
+        std::string line(entry.length, '\0');
+        reader.clear();
+        reader.seekg(static_cast<std::streamoff>(entry.offset));
+        if (!reader.read(&line[0], entry.length)) return false;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (parse_customer_line(line, out) || out.id != entry.id) return false;
+        lru.push_front(out);
+        cached[entry.id] = lru.begin();
+        if (lru.size() > cache_capacity) {
+            cached.erase(lru.back().id);
+            lru.pop_back();
+        }
+        return true;
+    }
+};
+
+
+// --- Terminal Renderer ---
+
+// Composes each screen in an in-memory frame and draws only the cells that
+// changed since the last frame, as a single write of ANSI escapes. While it is
+// installed std::cout writes into the frame, and the frame is shown whenever
+// the program waits for input or pauses. Input read through std::cin is copied
+// into the frame as the terminal echoes it, so the two never disagree.
+class TerminalRenderer : public std::streambuf {
+public:
+    // Takes over std::cout and std::cin if stdout is a terminal that
+    // understands ANSI escapes. Returns false (and changes nothing) otherwise.
+    static bool install() {
+        if (instance) return true;
+#ifdef _WIN32
+        if (!_isatty(_fileno(stdout))) return false;
+        HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (!GetConsoleMode(out, &mode) || !SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)) return false;
+#else
+        if (!isatty(STDOUT_FILENO)) return false;
+#endif
+        instance = new TerminalRenderer();
+        return true;
+    }
+
+    // Shows the last frame and gives std::cout and std::cin back
+    static void uninstall() {
+        if (!instance) return;
+        instance->present();
+        // Leave the cursor below the last line in use
+        int last = instance->height - 1;
+        while (last > 0 && instance->rows[last].find_first_not_of(' ') == std::string::npos) last--;
+        std::string tail = "\033[" + std::to_string(last + 1) + ";1H\n";
+        fwrite(tail.data(), 1, tail.size(), stdout);
+        fflush(stdout);
+        delete instance;
+        instance = nullptr;
+    }
+
+    static TerminalRenderer* active() { return instance; }
+
+    // Starts a new, blank frame. Nothing is written until present().
+    void clear() {
+        resize_to_terminal();
+        for (auto& row : rows) row.assign(width, ' ');
+        cursor_x = cursor_y = 0;
+    }
+
+    // Copies prepared rows over the top of the frame
+    void blit(const std::vector<std::string>& frame) {
+        for (int y = 0; y < height && y < static_cast<int>(frame.size()); ++y) {
+            rows[y].replace(0, std::min<size_t>(width, frame[y].size()), frame[y], 0, width);
+        }
+    }
+
+    void move_to(int x, int y) {
+        cursor_x = std::max(0, x);
+        cursor_y = std::min(std::max(0, y), height - 1);
+    }
+
+    // Writes the cells that differ from what is on screen, then parks the
+    // cursor where the next output or echo belongs
+    void present() {
+        if (shown_valid && cursor_x == shown_x && cursor_y == shown_y && rows == shown) return;
+        ScopedTimer timer(Metric::UI_RENDER);
+        std::string out = "\033[?25l";
+        if (!shown_valid) out += "\033[2J";
+        for (int y = 0; y < height; ++y) {
+            const std::string& row = rows[y];
+            const std::string& old = shown[y];
+            if (shown_valid && row == old) continue;
+            // Multi-byte characters cannot be split, so such rows are redrawn whole
+            bool whole = !shown_valid || std::any_of(row.begin(), row.end(), [](char c) { return c & 0x80; });
+            int x = 0;
+            while (x < width) {
+                if (!whole && row[x] == old[x]) {
+                    x++;
+                    continue;
+                }
+                int start = x, end = x;
+                for (int gap = 0; x < width && gap < 8; ++x) {
+                    if (whole || row[x] != old[x]) {
+                        end = x + 1;
+                        gap = 0;
+                    } else {
+                        gap++;
+                    }
+                }
+                if (!shown_valid) end = static_cast<int>(row.find_last_not_of(' ') + 1);
+                if (end <= start) continue;
+                out += "\033[" + std::to_string(y + 1) + ";" + std::to_string(start + 1) + "H";
+                out.append(row, start, end - start);
+            }
+            shown[y] = row;
+        }
+        shown_valid = true;
+        shown_x = cursor_x;
+        shown_y = cursor_y;
+        out += "\033[" + std::to_string(cursor_y + 1) + ";" + std::to_string(std::min(cursor_x, width) + 1) + "H\033[?25h";
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+
+protected:
+    int overflow(int ch) override {
+        if (ch != EOF) put(static_cast<char>(ch));
+        return ch;
+    }
+
+    std::streamsize xsputn(const char* text, std::streamsize count) override {
+        for (std::streamsize i = 0; i < count; ++i) put(text[i]);
+        return count;
+    }
+
+private:
+    // Forwards std::cin to the real input, showing the frame before it can
+    // block and copying each character read into the frame
+    class InputEcho : public std::streambuf {
+    public:
+        InputEcho(std::streambuf* source, TerminalRenderer& screen) : source(source), screen(screen) {}
+
+    protected:
+        int underflow() override {
+            screen.present();
+            return source->sgetc();
+        }
+        int uflow() override {
+            screen.present();
+            int ch = source->sbumpc();
+            if (ch != EOF) screen.put(static_cast<char>(ch), true);
+            return ch;
+        }
+        int pbackfail(int ch) override { return source->sungetc() == EOF ? EOF : ch; }
+
+    private:
+        std::streambuf* source;
+        TerminalRenderer& screen;
+    };
+
+    static inline TerminalRenderer* instance = nullptr;
+
+    std::vector<std::string> rows;      // The frame being composed
+    std::vector<std::string> shown;     // What the terminal shows
+    bool shown_valid = false;
+    int shown_x = 0;                    // Where the terminal's cursor is
+    int shown_y = 0;
+    int width = 0;
+    int height = 0;
+    int cursor_x = 0;
+    int cursor_y = 0;
+    std::streambuf* saved_out;
+    std::streambuf* saved_in;
+    InputEcho echo;
+
+    TerminalRenderer()
+        : saved_out(std::cout.rdbuf()), saved_in(std::cin.rdbuf()), echo(std::cin.rdbuf(), *this) {
+        clear();
+        std::cout.rdbuf(this);
+        std::cin.rdbuf(&echo);
+    }
+
+    ~TerminalRenderer() override {
+        std::cout.rdbuf(saved_out);
+        std::cin.rdbuf(saved_in);
+    }
+
+    // Follows the terminal size. The last column is never used, so writing a
+    // full row can not make the terminal wrap or scroll.
+    void resize_to_terminal() {
+        int columns = 150, lines = 60;
+#ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+            columns = info.srWindow.Right - info.srWindow.Left + 1;
+            lines = info.srWindow.Bottom - info.srWindow.Top + 1;
+        }
+#else
+        struct winsize size;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+            columns = size.ws_col;
+            lines = size.ws_row;
+        }
+#endif
+        if (columns - 1 == width && lines == height) return;
+        width = std::max(1, columns - 1);
+        height = std::max(1, lines);
+        rows.assign(height, std::string(width, ' '));
+        shown.assign(height, std::string(width, ' '));
+        shown_valid = false;
+    }
+
+    // Adds one character at the cursor. Input the terminal has already echoed
+    // is recorded as shown too, so it is not drawn a second time.
+    void put(char ch, bool echoed = false) {
+        switch (ch) {
+            case '\n':
+                cursor_x = 0;
+                if (++cursor_y == height) {
+                    // Scroll the frame up a line, as the terminal would
+                    std::rotate(rows.begin(), rows.begin() + 1, rows.end());
+                    rows.back().assign(width, ' ');
+                    if (echoed) {
+                        std::rotate(shown.begin(), shown.begin() + 1, shown.end());
+                        shown.back().assign(width, ' ');
+                    }
+                    cursor_y = height - 1;
+                }
+                break;
+            case '\r': cursor_x = 0; break;
+            case '\t': cursor_x = (cursor_x / 8 + 1) * 8; break;
+            case '\b': if (cursor_x > 0) cursor_x--; break;
+            default:
+                if (cursor_x < width) {
+                    rows[cursor_y][cursor_x] = ch;
+                    if (echoed) shown[cursor_y][cursor_x] = ch;
+                }
+                cursor_x++;
+        }
+        if (echoed) {
+            shown_x = cursor_x;
+            shown_y = cursor_y;
+        }
+    }
+};
+
+
+// --- Utility Functions ---
+
+#ifndef _WIN32
+// POSIX stand-ins for the Windows console calls used by the menus
+
+// Reads one key press without echo or waiting for Enter
+int _getch() {
+    struct termios old_attr, raw_attr;
+    tcgetattr(STDIN_FILENO, &old_attr);
+    raw_attr = old_attr;
+    raw_attr.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw_attr);
+    int ch = getchar();
+    tcsetattr(STDIN_FILENO, TCSANOW, &old_attr);
+    return ch;
+}
+
+void Sleep(unsigned int milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+#endif
+
+// Sets cursor position in the console
+void gotoxy(int x, int y) {
+    if (TerminalRenderer* screen = TerminalRenderer::active()) {
+        screen->move_to(x, y);
+        return;
+    }
+#ifdef _WIN32
+    COORD coord;
+    coord.X = x;
+    coord.Y = y;
+    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+#else
+    std::cout << "\033[" << y + 1 << ";" << x + 1 << "H" << std::flush;
+#endif
+}
+
+// Clears the console screen
+void clear_screen() {
+    if (TerminalRenderer* screen = TerminalRenderer::active()) {
+        screen->clear();
+        return;
+    }
+#ifdef _WIN32
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(out, &info)) {
+        DWORD cells = info.dwSize.X * info.dwSize.Y, written;
+        COORD home = {0, 0};
+        FillConsoleOutputCharacterA(out, ' ', cells, home, &written);
+        FillConsoleOutputAttribute(out, info.wAttributes, cells, home, &written);
+        SetConsoleCursorPosition(out, home);
+    }
+#else
+    std::cout << "\033[2J\033[H" << std::flush;
+#endif
+}
+
+// Shows the current screen, then reads one key press without echo
+int read_key() {
+    if (TerminalRenderer* screen = TerminalRenderer::active()) screen->present();
+    return _getch();
+}
+
+// Shows the current screen, then pauses
+void pause_screen(unsigned int milliseconds) {
+    if (TerminalRenderer* screen = TerminalRenderer::active()) screen->present();
+    Sleep(milliseconds);
+}
+
+// Pauses execution until a key is pressed
+void press_any_key_to_continue() {
+    std::cout << "\n\n\t | \t\t\tPress any key to continue...";
+    read_key();
+}
+
+// Gets the current date and time as a string
+std::string format_date_time(time_t when, const char* format) {
+    struct tm tstruct;
+    char buf[80];
+#ifdef _WIN32
+    localtime_s(&tstruct, &when);
+#else
+    localtime_r(&when, &tstruct);
+#endif
+    strftime(buf, sizeof(buf), format, &tstruct);
+    return buf;
+}
+
+std::string current_date_time() {
+    return format_date_time(time(0), "%d/%m/%Y TIME: %X");
+}
+
+// A whole screen prepared ahead of time: the border plus any art, as rows of
+// text, and where the cursor is left once it has been drawn
+struct ArtFrame {
+    std::vector<std::string> rows;
+    std::string ansi;           // The same rows as one ready-to-emit ANSI string
+    int cursor_x = 0;
+    int cursor_y = 0;
+    bool has_art = false;
+};
+
+// Keeps the art files in memory as prepared frames, so menu redraws read
+// nothing from disk. A file's modification time is checked at most once per
+// RECHECK_INTERVAL, and the frame is rebuilt only when it changed.
+class ArtCache {
+public:
+    static constexpr std::chrono::seconds RECHECK_INTERVAL{1};
+
+    const ArtFrame& border() {
+        if (border_frame.rows.empty()) border_frame = build(nullptr);
+        return border_frame;
+    }
+
+    const ArtFrame& get(const std::string& filename) {
+        Entry& entry = entries[filename];
+        auto now = std::chrono::steady_clock::now();
+        if (entry.loaded && now - entry.checked < RECHECK_INTERVAL) return entry.frame;
+        entry.checked = now;
+
+        std::error_code ec;
+        auto modified = std::filesystem::last_write_time(filename, ec);
+        bool exists = !ec;
+        if (entry.loaded && exists == entry.exists && (!exists || modified == entry.modified)) return entry.frame;
+
+        std::vector<std::string> lines;
+        std::ifstream ifs(filename);
+        std::string line;
+        while (ifs && std::getline(ifs, line)) lines.push_back(line);
+        entry.frame = build(ifs.is_open() ? &lines : nullptr);
+        entry.exists = exists;
+        entry.modified = modified;
+        entry.loaded = true;
+        return entry.frame;
+    }
+
+private:
+    struct Entry {
+        ArtFrame frame;
+        bool loaded = false;
+        bool exists = false;
+        std::filesystem::file_time_type modified;
+        std::chrono::steady_clock::time_point checked;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    ArtFrame border_frame;
+
+    // Lays the border and the art out exactly as drawing them in place would
+    static ArtFrame build(const std::vector<std::string>* art) {
+        ArtFrame frame;
+        frame.rows.assign(59, std::string());
+        auto draw = [&frame](int x, int y, const std::string& text) {
+            for (char ch : text) {
+                if (ch == '\r') { x = 0; continue; }
+                if (ch == '\t') { x = (x / 8 + 1) * 8; continue; }
+                if (y >= static_cast<int>(frame.rows.size())) frame.rows.resize(y + 1);
+                std::string& row = frame.rows[y];
+                if (static_cast<int>(row.size()) <= x) row.resize(x + 1, ' ');
+                row[x++] = ch;
+            }
+        };
+
+        draw(10, 10, std::string(130, '='));
+        draw(10, 58, std::string(130, '='));
+        for (int i = 10; i < 58; i++) {
+            draw(10, i, "|");
+            draw(140, i, "|");
+        }
+        frame.cursor_y = 20;
+        if (art) {
+            for (const std::string& line : *art) draw(0, frame.cursor_y++, line);
+            frame.has_art = true;
+        }
+
+        frame.ansi = "\033[2J";
+        for (size_t y = 0; y < frame.rows.size(); ++y) {
+            if (frame.rows[y].empty()) continue;
+            frame.ansi += "\033[" + std::to_string(y + 1) + ";1H" + frame.rows[y];
+        }
+        frame.ansi += "\033[" + std::to_string(frame.cursor_y + 1) + ";1H";
+        return frame;
+    }
+};
+
+ArtCache& art_cache() {
+    static ArtCache cache;
+    return cache;
+}
+
+// Puts a prepared frame on the (cleared) screen and leaves the cursor after it
+void show_frame(const ArtFrame& frame) {
+    if (TerminalRenderer* screen = TerminalRenderer::active()) {
+        screen->clear();
+        screen->blit(frame.rows);
+        screen->move_to(frame.cursor_x, frame.cursor_y);
+        return;
+    }
+#ifdef _WIN32
+    clear_screen();
+    for (size_t y = 0; y < frame.rows.size(); ++y) {
+        if (frame.rows[y].empty()) continue;
+        gotoxy(0, static_cast<int>(y));
+        std::cout << frame.rows[y];
+    }
+    gotoxy(frame.cursor_x, frame.cursor_y);
+#else
+    std::cout << frame.ansi << std::flush;
+#endif
+}
+
+// Displays a border on the screen
+void draw_border() {
+    show_frame(art_cache().border());
+}
+
+// Displays a loading animation
+void display_loading_bar(const std::string& message) {
+#ifdef _WIN32
+    const char block = static_cast<char>(177);
+#else
+    const char block = '#';
+#endif
+    draw_border();
+    gotoxy(65, 34);
+    std::cout << message;
+    gotoxy(60, 36);
+    std::cout << std::string(5 + rand() % 15, block);
+    pause_screen(100);
+    clear_screen();
+}
+
+// Displays ASCII art from a file, through the art cache
+void display_art(const std::string& filename) {
+    const ArtFrame& frame = art_cache().get(filename);
+    show_frame(frame);
+    if (frame.has_art) {
+        gotoxy(20, 15);
+        std::cout << "\t\t\t\tDATE: " << current_date_time() << std::endl;
+    }
+}
+
+
+// --- Transaction Log ---
+
+// How far a batch of log records is pushed before the writer sleeps again
+enum class LogDurability {
+    BUFFERED,   // Left in the stdio buffer; written when it fills or on shutdown
+    FLUSH,      // Handed to the OS after every batch
+    FSYNC       // Forced to disk after every batch
+};
+
+enum class LogFormat {
+    BLOCK,      // The human readable multi-line block in Log.txt
+    CSV,        // One line per rental in Log.csv
+    BOTH
+};
+
+struct LogConfig {
+    LogFormat format = LogFormat::BLOCK;
+    LogDurability durability = LogDurability::FLUSH;
+    std::chrono::milliseconds flush_interval{50};
+};
+
+// Starts every block in Log.txt
+const char LOG_SEPARATOR[] = "\n==========================================================";
+
+// One rental, as handed from the request path to the log writer
+struct TransactionRecord {
+    time_t when;
+    int customer_id;
+    std::string customer_name;
+    std::string plate;
+    std::string brand;
+    std::string model;
+    int hours;
+    long long cents;
+};
+
+// Unbounded multi-producer, single-consumer queue (Vyukov's intrusive design).
+// push is wait-free; pop may briefly report empty while a push is half done.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {}
+    }
+
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+        push_node(node);
+    }
+
+    bool pop(T& value) {
+        Node* first = tail;
+        Node* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (!next) return false;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (!next) {
+            if (first != head.load(std::memory_order_acquire)) return false;
+            push_node(&stub);
+            next = first->next.load(std::memory_order_acquire);
+            if (!next) return false;
+        }
+        tail = next;
+        value = std::move(first->value);
+        delete first;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+    };
+
+    void push_node(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    std::atomic<Node*> head;
+    Node* tail;     // Only touched by the consumer
+    Node stub;
+};
+
+// Takes Log.txt writes off the rental path. Records are queued without locking
+// and a background thread formats them and writes each batch with a single
+// write (group commit) every flush interval.
+class TransactionLog {
+public:
+    ~TransactionLog() { stop(); }
+
+    void start(const LogConfig& log_config) {
+        stop();
+        config = log_config;
+        if (config.format != LogFormat::CSV) block_file = fopen("Log.txt", "ab");
+        if (config.format != LogFormat::BLOCK) {
+            bool is_new = !std::filesystem::exists("Log.csv") || std::filesystem::file_size("Log.csv") == 0;
+            csv_file = fopen("Log.csv", "ab");
+            if (csv_file && is_new) fputs("date,customer_id,customer_name,plate,brand,model,hours,payment\n", csv_file);
+        }
+        stopping = false;
+        writer = std::thread(&TransactionLog::run, this);
+    }
+
+    // Writes out everything still queued and stops the writer thread
+    void stop() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+        for (FILE** file : {&block_file, &csv_file}) {
+            if (*file) {
+                sync_file(*file);
+                fclose(*file);
+                *file = nullptr;
+            }
+        }
+    }
+
+    void append(TransactionRecord record) {
+        queue.push(std::move(record));
+        appended.fetch_add(1, std::memory_order_release);
+    }
+
+    // Blocks until everything appended so far has been handed to the OS
+    void flush() {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        if (!writer.joinable()) return;
+        uint64_t target = appended.load(std::memory_order_acquire);
+        flush_requested = true;
+        wake.notify_one();
+        flushed.wait(lock, [&] { return written >= target || stopping; });
+    }
+
+private:
+    LogConfig config;
+    MpscQueue<TransactionRecord> queue;
+    FILE* block_file = nullptr;
+    FILE* csv_file = nullptr;
+    std::thread writer;
+    std::mutex wake_mutex;          // Only used to sleep the writer, never by producers
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    bool stopping = false;
+    bool flush_requested = false;
+    std::atomic<uint64_t> appended{0};
+    uint64_t written = 0;           // Guarded by wake_mutex
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        for (;;) {
+            wake.wait_for(lock, config.flush_interval, [this] { return stopping || flush_requested; });
+            bool last = stopping;
+            bool force = flush_requested;
+            flush_requested = false;
+            lock.unlock();
+            uint64_t count = write_batch(force);
+            lock.lock();
+            written += count;
+            flushed.notify_all();
+            if (last) break;
+        }
+    }
+
+    uint64_t write_batch(bool force) {
+        std::string block, csv;
+        TransactionRecord record;
+        uint64_t count = 0;
+        while (queue.pop(record)) {
+            if (block_file) append_block(block, record);
+            if (csv_file) append_csv(csv, record);
+            count++;
+        }
+        commit(block_file, block, force);
+        commit(csv_file, csv, force);
+        return count;
+    }
+
+    void commit(FILE* file, const std::string& batch, bool force) {
+        if (!file) return;
+        if (!batch.empty()) fwrite(batch.data(), 1, batch.size(), file);
+        if (config.durability == LogDurability::FSYNC && !batch.empty()) sync_file(file);
+        else if (force || (config.durability == LogDurability::FLUSH && !batch.empty())) fflush(file);
+    }
+
+    static void append_block(std::string& out, const TransactionRecord& record) {
+        out += LOG_SEPARATOR;
+        out += "\nDATE: " + format_date_time(record.when, "%d/%m/%Y TIME: %X");
+        out += "\nCUSTOMER: " + record.customer_name + " (ID: " + std::to_string(record.customer_id) + ")";
+        out += "\nCAR: " + record.plate + " (" + record.brand + " " + record.model + ")";
+        out += "\nHOURS: " + std::to_string(record.hours);
+        out += "\nPAYMENT: RM " + format_money(record.cents);
+    }
+
+    static std::string csv_field(const std::string& text) {
+        if (text.find_first_of(",\"\n") == std::string::npos) return text;
+        std::string quoted = "\"";
+        for (char c : text) quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+        return quoted + "\"";
+    }
+
+    static void append_csv(std::string& out, const TransactionRecord& record) {
+        out += format_date_time(record.when, "%Y-%m-%d %H:%M:%S") + "," + std::to_string(record.customer_id) + "," +
+               csv_field(record.customer_name) + "," + csv_field(record.plate) + "," + csv_field(record.brand) + "," +
+               csv_field(record.model) + "," + std::to_string(record.hours) + "," + format_money(record.cents) + "\n";
+    }
+};
+
+
+// --- Sales Analytics ---
+
+// Rentals, booked hours and revenue for one car, brand, customer or day
+struct SalesTotals {
+    uint64_t rentals = 0;
+    uint64_t hours = 0;
+    long long cents = 0;
+
+    void add(const SalesTotals& other) {
+        rentals += other.rentals;
+        hours += other.hours;
+        cents += other.cents;
+    }
+};
+
+struct CarSales {
+    std::string brand;
+    std::string model;
+    SalesTotals totals;
+};
+
+struct CustomerSales {
+    std::string name;
+    SalesTotals totals;
+};
+
+// Everything rented on one calendar day
+struct DayRollup {
+    std::map<std::string, CarSales, std::less<>> cars;  // By plate
+    std::map<int, CustomerSales> customers;             // By customer id
+
+    void merge(const DayRollup& other) {
+        for (const auto& [plate, sales] : other.cars) {
+            CarSales& into = cars[plate];
+            into.brand = sales.brand;
+            into.model = sales.model;
+            into.totals.add(sales.totals);
+        }
+        for (const auto& [id, sales] : other.customers) {
+            CustomerSales& into = customers[id];
+            into.name = sales.name;
+            into.totals.add(sales.totals);
+        }
+    }
+};
+
+using DailyRollups = std::map<int, DayRollup>;  // By day as yyyymmdd
+
+void merge_rollups(DailyRollups& into, const DailyRollups& from) {
+    for (const auto& [day, rollup] : from) into[day].merge(rollup);
+}
+
+// Parses "d/m/yyyy" into yyyymmdd. Anything after the year is ignored.
+bool parse_day(std::string_view text, int& day) {
+    int parts[3];
+    for (int i = 0; i < 3; ++i) {
+        size_t end = i < 2 ? text.find('/') : text.find_first_not_of("0123456789");
+        if (!parse_number(text.substr(0, end), parts[i])) return false;
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + (i < 2));
+    }
+    if (parts[0] < 1 || parts[0] > 31 || parts[1] < 1 || parts[1] > 12 || parts[2] < 1900) return false;
+    day = parts[2] * 10000 + parts[1] * 100 + parts[0];
+    return true;
+}
+
+// Days since 1970-01-01 for a yyyymmdd day
+long long days_from_civil(int day) {
+    long long y = day / 10000, m = day / 100 % 100, d = day % 100;
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+// Parses "123", "31.5" or "80.00" into cents, rounding anything past two decimals
+bool parse_cents(std::string_view text, long long& cents) {
+    size_t dot = text.find('.');
+    long long whole = 0;
+    if (!parse_number(text.substr(0, dot), whole)) return false;
+    long long fraction = 0;
+    if (dot != std::string_view::npos) {
+        std::string_view digits = text.substr(dot + 1);
+        if (digits.empty() || digits.find_first_not_of("0123456789") != std::string_view::npos) return false;
+        for (size_t i = 0; i < 3; ++i) fraction = fraction * 10 + (i < digits.size() ? digits[i] - '0' : 0);
+        fraction = (fraction + 5) / 10;
+    }
+    cents = whole * 100 + fraction;
+    return true;
+}
+
+// One DATE/CUSTOMER/CAR/HOURS/PAYMENT block of Log.txt
+struct LoggedRental {
+    int day = 0;
+    int customer_id = 0;
+    std::string_view customer_name;
+    std::string_view plate;
+    std::string_view brand;
+    std::string_view model;
+    int hours = 0;
+    long long cents = 0;
+};
+
+// Parses the lines of one block (without its separator). Returns an error message or nullptr.
+const char* parse_log_block(std::string_view block, LoggedRental& rental) {
+    int seen = 0;
+    while (!block.empty()) {
+        size_t end = block.find('\n');
+        std::string_view line = block.substr(0, end);
+        block.remove_prefix(end == std::string_view::npos ? block.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        auto field = [&line](std::string_view label) {
+            if (line.substr(0, label.size()) != label) return false;
+            line.remove_prefix(label.size());
+            return true;
+        };
+        if (field("DATE: ")) {
+            if (!parse_day(line, rental.day)) return "invalid date";
+            seen |= 1;
+        } else if (field("CUSTOMER: ")) {
+            size_t id = line.rfind(" (ID: ");
+            if (id == std::string_view::npos || line.back() != ')') return "invalid customer";
+            if (!parse_number(line.substr(id + 6, line.size() - id - 7), rental.customer_id)) return "invalid customer id";
+            rental.customer_name = line.substr(0, id);
+            seen |= 2;
+        } else if (field("CAR: ")) {
+            size_t open = line.find(" (");
+            if (open == std::string_view::npos || line.back() != ')') return "invalid car";
+            rental.plate = line.substr(0, open);
+            std::string_view name = line.substr(open + 2, line.size() - open - 3);
+            size_t space = name.find(' ');
+            rental.brand = name.substr(0, space);
+            if (rental.plate.empty() || rental.brand.empty()) return "invalid car";
+            rental.model = space == std::string_view::npos ? std::string_view() : name.substr(space + 1);
+            seen |= 4;
+        } else if (field("HOURS: ")) {
+            if (!parse_number(line, rental.hours)) return "invalid hours";
+            seen |= 8;
+        } else if (field("PAYMENT: RM ")) {
+            if (!parse_cents(line, rental.cents)) return "invalid payment";
+            seen |= 16;
+        }
+    }
+    return seen == 31 ? nullptr : "incomplete block";
+}
+
+// Finds the next block separator at or after `from`. Jumps between line breaks
+// with memchr, which is much faster than a generic substring search here.
+size_t find_log_separator(std::string_view text, size_t from) {
+    const std::string_view separator = LOG_SEPARATOR;
+    while (from < text.size()) {
+        const void* found = memchr(text.data() + from, '\n', text.size() - from);
+        if (!found) break;
+        from = static_cast<const char*>(found) - text.data();
+        if (text.compare(from, separator.size(), separator) == 0) return from;
+        from++;
+    }
+    return std::string_view::npos;
+}
+
+// Parses the blocks in `text` on worker threads and folds them into `rollups`.
+// Returns the number of malformed blocks.
+size_t scan_log_blocks(std::string_view text, DailyRollups& rollups) {
+    static const size_t MIN_CHUNK_BYTES = 1 << 20;
+    const std::string_view separator = LOG_SEPARATOR;
+
+    struct Chunk {
+        std::string_view text;
+        DailyRollups rollups;
+        size_t malformed = 0;
+    };
+
+    // Split on block boundaries so no block straddles two workers
+    size_t workers = std::thread::hardware_concurrency();
+    workers = std::max<size_t>(1, std::min<size_t>(workers, text.size() / MIN_CHUNK_BYTES + 1));
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    for (size_t i = 0; i < workers && begin < text.size(); ++i) {
+        size_t end = i + 1 == workers ? text.size() : find_log_separator(text, std::max(begin + 1, (i + 1) * text.size() / workers));
+        end = std::min(end, text.size());
+        chunks.push_back(Chunk{text.substr(begin, end - begin), {}, 0});
+        begin = end;
+    }
+
+    auto scan_chunk = [separator](Chunk& chunk) {
+        size_t at = find_log_separator(chunk.text, 0);
+        while (at != std::string_view::npos) {
+            size_t start = at + separator.size();
+            size_t next = find_log_separator(chunk.text, start);
+            std::string_view block = chunk.text.substr(start, next == std::string_view::npos ? std::string_view::npos : next - start);
+            at = next;
+
+            LoggedRental rental;
+            if (parse_log_block(block, rental)) {
+                chunk.malformed++;
+                continue;
+            }
+            SalesTotals totals{1, static_cast<uint64_t>(std::max(0, rental.hours)), rental.cents};
+            DayRollup& day = chunk.rollups[rental.day];
+            auto car = day.cars.find(rental.plate);
+            if (car == day.cars.end()) car = day.cars.emplace(std::string(rental.plate), CarSales()).first;
+            if (car->second.brand != rental.brand) car->second.brand.assign(rental.brand);
+            if (car->second.model != rental.model) car->second.model.assign(rental.model);
+            car->second.totals.add(totals);
+            CustomerSales& cust = day.customers[rental.customer_id];
+            if (cust.name != rental.customer_name) cust.name.assign(rental.customer_name);
+            cust.totals.add(totals);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunks.size(); ++i) threads.emplace_back(scan_chunk, std::ref(chunks[i]));
+    if (!chunks.empty()) scan_chunk(chunks[0]);
+    for (auto& t : threads) t.join();
+
+    size_t malformed = 0;
+    for (const auto& chunk : chunks) {
+        merge_rollups(rollups, chunk.rollups);
+        malformed += chunk.malformed;
+    }
+    return malformed;
+}
+
+// Totals over a range of days, largest revenue first
+struct SalesReport {
+    int first_day = 0;      // yyyymmdd range the utilization is measured over
+    int last_day = 0;
+    SalesTotals total;
+    std::vector<std::pair<int, SalesTotals>> days;
+    std::vector<std::pair<std::string, CarSales>> cars;
+    std::vector<std::pair<std::string, SalesTotals>> brands;
+    std::vector<std::pair<int, CustomerSales>> customers;
+    size_t malformed = 0;
+
+    // Share of the range's hours that a car was booked for
+    double utilization(const SalesTotals& totals) const {
+        long long days_in_range = first_day ? days_from_civil(last_day) - days_from_civil(first_day) + 1 : 0;
+        return days_in_range > 0 ? 100.0 * totals.hours / (days_in_range * 24.0) : 0.0;
+    }
+};
+
+// Per-day rollups of Log.txt, cached in Log.rollup so a report only parses the
+// blocks appended since the previous one. The cache holds a hash of the start
+// of the log and of the bytes just before where it stopped, and the log's
+// modification time, so a truncated, rewritten or restored log is noticed
+// without reading all of it again. The last block is kept out of the cache
+// because the log writer may still be in the middle of it.
+class SalesAnalytics {
+public:
+    explicit SalesAnalytics(std::string log_path = "Log.txt", std::string cache_path = "Log.rollup")
+        : log_path(std::move(log_path)), cache_path(std::move(cache_path)) {}
+
+    // Brings the rollups up to date with the log. Returns the number of bytes parsed.
+    size_t refresh() {
+        if (!cache_loaded) load_cache();
+        cache_loaded = true;
+
+        MappedFile file;
+        std::string_view text = file.open(log_path) ? file.view() : std::string_view();
+        // A shorter, rewritten or older log invalidates everything cached so far
+        long long modified = modified_time(log_path);
+        if (text.size() < offset || window_hash(text, offset) != hash || modified < log_modified) {
+            cached.clear();
+            offset = 0;
+            hash = window_hash({}, 0);
+            cached_malformed = 0;
+        }
+
+        std::string_view fresh = text.substr(offset);
+        size_t last = fresh.rfind(LOG_SEPARATOR);
+        if (last == std::string_view::npos) last = 0;
+        tail.clear();
+        tail_malformed = scan_log_blocks(fresh.substr(last), tail);
+        if (last > 0) {
+            cached_malformed += scan_log_blocks(fresh.substr(0, last), cached);
+            offset += last;
+            hash = window_hash(text, offset);
+            log_modified = modified;
+            save_cache();
+        }
+        return fresh.size();
+    }
+
+    // Totals for rentals made between two yyyymmdd days (0 leaves that end open)
+    SalesReport report(int from_day, int to_day) const {
+        SalesReport result;
+        DayRollup range;
+        std::map<int, SalesTotals> days;
+        for (const DailyRollups* rollups : {&cached, &tail}) {
+            for (auto it = rollups->lower_bound(from_day); it != rollups->end() && (!to_day || it->first <= to_day); ++it) {
+                range.merge(it->second);
+                for (const auto& [plate, car] : it->second.cars) days[it->first].add(car.totals);
+            }
+        }
+
+        result.first_day = from_day ? from_day : (days.empty() ? 0 : days.begin()->first);
+        result.last_day = to_day ? to_day : (days.empty() ? 0 : days.rbegin()->first);
+        result.days.assign(days.begin(), days.end());
+        std::map<std::string, SalesTotals> brands;
+        for (const auto& [plate, car] : range.cars) {
+            result.total.add(car.totals);
+            brands[car.brand].add(car.totals);
+            result.cars.emplace_back(plate, car);
+        }
+        result.brands.assign(brands.begin(), brands.end());
+        result.customers.assign(range.customers.begin(), range.customers.end());
+        result.malformed = cached_malformed + tail_malformed;
+
+        auto by_revenue = [](const auto& a, const auto& b) { return revenue(a.second) > revenue(b.second); };
+        std::stable_sort(result.cars.begin(), result.cars.end(), by_revenue);
+        std::stable_sort(result.brands.begin(), result.brands.end(), by_revenue);
+        std::stable_sort(result.customers.begin(), result.customers.end(), by_revenue);
+        return result;
+    }
+
+private:
+    std::string log_path;
+    std::string cache_path;
+    DailyRollups cached;        // Blocks before `offset`
+    DailyRollups tail;          // The last block, re-read on every refresh
+    uint64_t offset = 0;
+    uint64_t hash = 0;
+    long long log_modified = 0;  // Of the log when `offset` was reached
+    size_t cached_malformed = 0;
+    size_t tail_malformed = 0;
+    bool cache_loaded = false;
+
+    // Version 1 hashed only the ends of the scanned part, version 2 all of it
+    static const int ROLLUP_VERSION = 3;
+
+    static long long revenue(const SalesTotals& totals) { return totals.cents; }
+    static long long revenue(const CarSales& sales) { return sales.totals.cents; }
+    static long long revenue(const CustomerSales& sales) { return sales.totals.cents; }
+
+    // Hashes the first and the last TAIL_CHECK_BYTES of the scanned part, so a
+    // refresh costs the same however long the log has grown
+    static uint64_t window_hash(std::string_view text, uint64_t size) {
+        size_t head = std::min<uint64_t>(size, TAIL_CHECK_BYTES);
+        return fnv1a(text.data(), head, tail_hash(text, size));
+    }
+
+    static long long modified_time(const std::string& path) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? 0 : static_cast<long long>(time.time_since_epoch().count());
+    }
+
+    // Log.rollup: a "ROLLUP 3 <offset> <hash> <modified> <malformed>" header, then a
+    // "D <day>" line per day followed by its "C" (car) and "U" (customer) lines
+    void load_cache() {
+        MappedFile file;
+        std::string_view rest = file.open(cache_path) ? file.view() : std::string_view();
+        auto next_line = [&rest]() {
+            size_t end = rest.find('\n');
+            std::string_view line = rest.substr(0, end);
+            rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+            return line;
+        };
+        auto trimmed = [](std::string_view text) {
+            size_t start = text.find_first_not_of(" \t");
+            return start == std::string_view::npos ? std::string_view() : text.substr(start);
+        };
+
+        std::string_view header = next_line();
+        int version = 0;
+        bool ok = next_field(header) == "ROLLUP" && parse_number(next_field(header), version) && version == ROLLUP_VERSION &&
+                  parse_number(next_field(header), offset) && parse_number(next_field(header), hash) &&
+                  parse_number(next_field(header), log_modified) && parse_number(next_field(header), cached_malformed);
+        DayRollup* day = nullptr;
+        while (ok && !rest.empty()) {
+            std::string_view line = next_line();
+            std::string_view tag = next_field(line);
+            SalesTotals totals;
+            if (tag == "D") {
+                int key = 0;
+                ok = parse_number(next_field(line), key);
+                day = &cached[key];
+            } else if (!day || !parse_number(next_field(line), totals.rentals) ||
+                       !parse_number(next_field(line), totals.hours) || !parse_number(next_field(line), totals.cents)) {
+                ok = false;
+            } else if (tag == "C") {
+                CarSales& car = day->cars[std::string(next_field(line))];
+                car.brand.assign(next_field(line));
+                car.model.assign(trimmed(line));
+                car.totals = totals;
+            } else if (tag == "U") {
+                int id = 0;
+                ok = parse_number(next_field(line), id);
+                CustomerSales& cust = day->customers[id];
+                cust.name.assign(trimmed(line));
+                cust.totals = totals;
+            } else {
+                ok = false;
+            }
+        }
+        if (!ok) {
+            cached.clear();
+            offset = 0;
+            hash = 0;
+            log_modified = 0;
+            cached_malformed = 0;
+        }
+    }
+
+    void save_cache() const {
+        std::string temp_name = cache_path + ".tmp";
+        std::ofstream out(temp_name);
+        out << "ROLLUP " << ROLLUP_VERSION << " " << offset << " " << hash << " " << log_modified << " "
+            << cached_malformed << "\n";
+        for (const auto& [key, day] : cached) {
+            out << "D " << key << "\n";
+            for (const auto& [plate, car] : day.cars) {
+                out << "C " << car.totals.rentals << " " << car.totals.hours << " " << car.totals.cents << " " << plate
+                    << " " << car.brand << " " << car.model << "\n";
+            }
+            for (const auto& [id, cust] : day.customers) {
+                out << "U " << cust.totals.rentals << " " << cust.totals.hours << " " << cust.totals.cents << " " << id
+                    << " " << cust.name << "\n";
+            }
+        }
+        out.close();
+        std::error_code ec;
+        std::filesystem::rename(temp_name, cache_path, ec);
+    }
+};
+
+std::string format_day(int day) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%02d/%02d/%04d", day % 100, day / 100 % 100, day / 10000);
+    return buf;
+}
+
+// Prints a report, listing at most `top` cars, brands and customers (0 for all)
+void print_sales_report(std::ostream& out, const SalesReport& report, size_t top, const char* indent) {
+    auto limit = [top](size_t size) { return top ? std::min(top, size) : size; };
+    char line[160];
+    out << indent << "PERIOD: " << (report.first_day ? format_day(report.first_day) : "-") << " TO "
+        << (report.last_day ? format_day(report.last_day) : "-") << "\n";
+    out << indent << "RENTALS: " << report.total.rentals << "   HOURS: " << report.total.hours
+        << "   REVENUE: RM " << format_money(report.total.cents) << "\n";
+    if (report.malformed) out << indent << "SKIPPED " << report.malformed << " unreadable log entries\n";
+
+    out << "\n" << indent << "REVENUE PER DAY\n";
+    for (const auto& [day, totals] : report.days) {
+        snprintf(line, sizeof(line), "%-12s %8llu rentals %10llu hours   RM %s", format_day(day).c_str(),
+                 static_cast<unsigned long long>(totals.rentals), static_cast<unsigned long long>(totals.hours),
+                 format_money(totals.cents).c_str());
+        out << indent << line << "\n";
+    }
+
+    out << "\n" << indent << "REVENUE AND UTILIZATION PER CAR\n";
+    for (size_t i = 0; i < limit(report.cars.size()); ++i) {
+        const auto& [plate, car] = report.cars[i];
+        snprintf(line, sizeof(line), "%-12s %-10s %-12s %6llu rentals %8llu hours %6.1f%%   RM %s", plate.c_str(),
+                 car.brand.c_str(), car.model.c_str(), static_cast<unsigned long long>(car.totals.rentals),
+                 static_cast<unsigned long long>(car.totals.hours), report.utilization(car.totals),
+                 format_money(car.totals.cents).c_str());
+        out << indent << line << "\n";
+    }
+
+    out << "\n" << indent << "REVENUE PER BRAND\n";
+    for (size_t i = 0; i < limit(report.brands.size()); ++i) {
+        const auto& [brand, totals] = report.brands[i];
+        snprintf(line, sizeof(line), "%-12s %8llu rentals %10llu hours   RM %s", brand.c_str(),
+                 static_cast<unsigned long long>(totals.rentals), static_cast<unsigned long long>(totals.hours),
+                 format_money(totals.cents).c_str());
+        out << indent << line << "\n";
+    }
+
+    out << "\n" << indent << "REVENUE PER CUSTOMER\n";
+    for (size_t i = 0; i < limit(report.customers.size()); ++i) {
+        const auto& [id, cust] = report.customers[i];
+        snprintf(line, sizeof(line), "%-8d %-20s %6llu rentals %8llu hours   RM %s", id, cust.name.c_str(),
+                 static_cast<unsigned long long>(cust.totals.rentals), static_cast<unsigned long long>(cust.totals.hours),
+                 format_money(cust.totals.cents).c_str());
+        out << indent << line << "\n";
+    }
+    out.flush();
+}
+
+// --report [from] [to] [top]: prints the sales report for a range of d/m/yyyy days
+int run_report(int argc, char* argv[]) {
+    int from_day = 0, to_day = 0;
+    if ((argc > 2 && std::string(argv[2]) != "-" && !parse_day(argv[2], from_day)) ||
+        (argc > 3 && std::string(argv[3]) != "-" && !parse_day(argv[3], to_day))) {
+        std::cerr << "Dates must be written as DD/MM/YYYY" << std::endl;
+        return 1;
+    }
+    size_t top = 0;
+    if (argc > 4 && !parse_number(argv[4], top)) {
+        std::cerr << "Rows per list must be a whole number" << std::endl;
+        return 1;
+    }
+    SalesAnalytics analytics;
+    auto start = std::chrono::steady_clock::now();
+    size_t parsed = analytics.refresh();
+    SalesReport report = analytics.report(from_day, to_day);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print_sales_report(std::cout, report, top, "");
+    std::cout << "\nParsed " << parsed << " new log bytes in " << seconds << " s" << std::endl;
+    return 0;
+}
+
+
+// --- List View ---
+
+// The slots in [0, slot_count) that pass a filter, found lazily as pages are
+// viewed. Matches are kept in a deque anchored where the list was opened or
+// jumped to, and only grow in either direction as far as the pages shown need,
+// so opening, jumping and paging cost about a page of rows, not the whole fleet.
+class PagedSlotList {
+public:
+    using Filter = std::function<bool(size_t)>;
+
+    PagedSlotList(size_t page_rows, size_t slot_count, Filter filter)
+        : rows(page_rows), slot_count(slot_count), filter(std::move(filter)) {}
+
+    // Restarts the list at the first match at or after `slot`
+    void jump(size_t slot) {
+        matches.clear();
+        top = 0;
+        forward = back = std::min(slot, slot_count);
+    }
+
+    // Replaces the filter. A narrower filter (one that can only reject more)
+    // rechecks just the matches already found instead of starting over.
+    void set_filter(Filter new_filter, bool narrower) {
+        filter = std::move(new_filter);
+        if (!narrower) {
+            jump(top < matches.size() ? matches[top] : forward);
+            return;
+        }
+        std::deque<size_t> kept;
+        size_t kept_top = 0;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (!filter(matches[i])) continue;
+            kept.push_back(matches[i]);
+            if (i < top) kept_top++;
+        }
+        matches.swap(kept);
+        top = kept_top;
+    }
+
+    // Slots on the current page
+    std::vector<size_t> page() {
+        fill_forward(top + rows + 1);
+        size_t end = std::min(matches.size(), top + rows);
+        return std::vector<size_t>(matches.begin() + std::min(top, end), matches.begin() + end);
+    }
+
+    bool next() {
+        fill_forward(top + 2 * rows);
+        if (top + rows >= matches.size()) return false;
+        top += rows;
+        return true;
+    }
+
+    bool prev() {
+        if (top < rows) fill_backward(rows - top);
+        if (top == 0) return false;
+        top -= std::min(top, rows);
+        return true;
+    }
+
+    bool has_next() const { return top + rows < matches.size() || forward < slot_count; }
+    bool has_prev() const { return top > 0 || back > 0; }
+
+    // Position of the page's first row, known once everything before it was scanned
+    bool position_known() const { return back == 0; }
+    size_t first_row() const { return top + 1; }
+
+    // Total matches, known once the whole range was scanned
+    bool complete() const { return back == 0 && forward == slot_count; }
+    size_t found() const { return matches.size(); }
+
+private:
+    size_t rows;
+    size_t slot_count;
+    Filter filter;
+    std::deque<size_t> matches;
+    size_t top = 0;         // Index in `matches` of the page's first row
+    size_t forward = 0;     // Next slot to scan going forward
+    size_t back = 0;        // Slots below this are not scanned yet
+
+    void fill_forward(size_t wanted) {
+        while (matches.size() < wanted && forward < slot_count) {
+            if (filter(forward)) matches.push_back(forward);
+            forward++;
+        }
+    }
+
+    void fill_backward(size_t wanted) {
+        for (size_t added = 0; added < wanted && back > 0;) {
+            if (filter(--back)) {
+                matches.push_front(back);
+                top++;
+                added++;
+            }
+        }
+    }
+};
+
+// Case-insensitive substring test, for filtering lists as the user types
+bool contains_ignore_case(std::string_view text, std::string_view needle) {
+    auto same = [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    };
+    return std::search(text.begin(), text.end(), needle.begin(), needle.end(), same) != text.end();
+}
+
+
+// --- Batch Allocation ---
+
+// One line of a bulk booking: `count` cars matching `cars` (its fields and
+// minimum capacity) for the window [cars.start, cars.end), each costing at
+// most `budget_cents` for the whole window
+struct AllocationRequest {
+    size_t count = 1;
+    CarQuery cars;                 // Rate range and limit are not used
+    int hours = 1;                 // Length of the window, for pricing
+    long long budget_cents = -1;   // Per car; negative = no budget
+};
+
+// What a batch is optimized for
+enum class AllocationGoal {
+    LOWEST_COST,   // Cheapest total
+    BEST_FIT       // Fewest seats beyond each request's minimum, then cheapest
+};
+
+struct Allocation {
+    size_t request;
+    size_t slot;
+    long long cents;
+    std::string plate;             // Set once booked
+};
+
+struct AllocationPlan {
+    bool complete = false;
+    size_t unfilled = 0;           // First request that could not be filled, if not complete
+    std::vector<Allocation> cars;  // By request, cheapest first
+    long long total_cents = 0;
+};
+
+// Applies one key=value option shared by car searches and bulk bookings:
+// brand, model, colour, transmission, branch, capacity (minimum seats), start
+// (hours from now) and hours. False for any other key or a bad value.
+bool parse_car_option(const std::string& key, const std::string& value, CarQuery& query, int& start_offset,
+                      int& hours) {
+    if (key == "brand") query.brand = value;
+    else if (key == "model") query.model = value;
+    else if (key == "colour") query.colour = value;
+    else if (key == "transmission") query.transmission = value;
+    else if (key == "branch") query.branch = value;
+    else if (key == "capacity") return parse_number(value, query.min_capacity);
+    else if (key == "start") return parse_number(value, start_offset);
+    else if (key == "hours") return parse_number(value, hours) && hours > 0;
+    else return false;
+    return true;
+}
+
+// Parses one request of a bulk booking, e.g.
+//   count=3 capacity=7 transmission=A budget=250 hours=24
+// count and budget (RM per car) plus any parse_car_option key. The window
+// starts `start` hours after `now` and may not start in the past.
+bool parse_allocation_request(const std::string& text, time_t now, AllocationRequest& request) {
+    request = AllocationRequest();
+    std::istringstream in(text);
+    std::string option;
+    int start_offset = 0;
+    bool any = false;
+    while (in >> option) {
+        any = true;
+        size_t eq = option.find('=');
+        std::string key = option.substr(0, eq), value = eq == std::string::npos ? "" : option.substr(eq + 1);
+        if (key == "count") {
+            if (!parse_number(value, request.count) || request.count == 0) return false;
+        } else if (key == "budget") {
+            if (!parse_cents(value, request.budget_cents)) return false;
+        } else if (!parse_car_option(key, value, request.cars, start_offset, request.hours)) {
+            return false;
+        }
+    }
+    if (!any || start_offset < 0) return false;
+    request.cars.start = now + static_cast<time_t>(start_offset) * 3600;
+    request.cars.end = request.cars.start + static_cast<time_t>(request.hours) * 3600;
+    return true;
+}
+
+// Parses a whole bulk booking: an optional goal ("cost", the default, or
+// "fit") and then requests separated by ';'
+bool parse_allocation_batch(const std::string& text, time_t now, AllocationGoal& goal,
+                            std::vector<AllocationRequest>& requests) {
+    requests.clear();
+    goal = AllocationGoal::LOWEST_COST;
+    std::string rest = text;
+    size_t first = rest.find_first_not_of(" \t");
+    size_t word_end = rest.find_first_of(" \t;", first);
+    std::string word = first == std::string::npos ? "" : rest.substr(first, word_end - first);
+    if (word == "cost" || word == "fit") {
+        goal = word == "fit" ? AllocationGoal::BEST_FIT : AllocationGoal::LOWEST_COST;
+        rest = word_end == std::string::npos ? "" : rest.substr(word_end);
+    }
+    std::istringstream in(rest);
+    std::string part;
+    while (std::getline(in, part, ';')) {
+        if (part.find_first_not_of(" \t") == std::string::npos) continue;
+        AllocationRequest request;
+        if (!parse_allocation_request(part, now, request)) return false;
+        requests.push_back(request);
+    }
+    return !requests.empty();
+}
+
+// Assigns cars to every request of a batch at once, each car serving at most
+// one request, so that all requests are filled at the lowest total weight: the
+// price, or for BEST_FIT the spare seats and then the price. Cars are only
+// chosen, not booked; see RentalSystem::allocate_batch.
+//
+// Candidates: a request never needs more than its D lightest free cars, D
+// being the number of cars the whole batch asks for. (Had it used a heavier
+// one, one of those D would be unused by the batch and swapping it in would
+// cost no more.) Finding them prices every matching car, so the work is cut
+// into (request, slot range) tasks that worker threads take in turn; each
+// task keeps its own D lightest free cars and the results are merged. The
+// helper threads come out of one budget of a thread per core shared by all
+// plans, so server workers allocating at the same time do not start a thread
+// per core each; a plan that finds none spare does its tasks alone.
+//
+// Assignment: a min-cost flow from the requests to the cars, found one car at
+// a time along the cheapest augmenting path (Dijkstra with potentials). The
+// graph only has request nodes: a request reaches the sink through any free
+// candidate, and another request through a candidate that request holds,
+// which then moves on to its next best car. This is O(D * candidates).
+class BatchAllocator {
+public:
+    static const size_t CHUNK_SLOTS = 1 << 16;   // Slots per task; a multiple of 64
+    static constexpr long long FIT_STEP = 1000000000000LL; // Outweighs any price in cents
+
+    BatchAllocator(const FleetStore& fleet, AllocationGoal goal) : fleet(fleet), goal(goal) {}
+
+    AllocationPlan plan(const std::vector<AllocationRequest>& requests) const {
+        AllocationPlan plan;
+        size_t demand = 0;
+        for (const AllocationRequest& request : requests) demand += request.count;
+        if (requests.empty() || demand == 0) return plan;
+
+        std::vector<std::vector<Candidate>> candidates = find_candidates(requests, demand);
+        for (size_t r = 0; r < requests.size(); ++r) {
+            if (candidates[r].size() < requests[r].count) {
+                plan.unfilled = r;
+                return plan;
+            }
+        }
+        assign(requests, candidates, demand, plan);
+        return plan;
+    }
+
+private:
+    struct Candidate {
+        long long weight;
+        long long cents;
+        size_t slot;
+        uint32_t car;     // Index among all the batch's candidate cars
+        bool operator<(const Candidate& other) const {
+            return weight != other.weight ? weight < other.weight : slot < other.slot;
+        }
+    };
+
+    long long weight_of(const AllocationRequest& request, const Quote& quote) const {
+        if (goal == AllocationGoal::LOWEST_COST) return quote.cents;
+        float spare = fleet.at(quote.slot).capacity - request.cars.min_capacity;
+        return std::llround(std::max(0.0f, spare) * 10) * FIT_STEP + quote.cents;
+    }
+
+    // Helper threads not in use by any plan; the calling thread is not counted
+    static std::atomic<size_t>& spare_helpers() {
+        static std::atomic<size_t> spare{std::max(1u, std::thread::hardware_concurrency()) - 1};
+        return spare;
+    }
+
+    // Takes up to `wanted` helpers out of the spare ones
+    static size_t take_helpers(size_t wanted) {
+        std::atomic<size_t>& spare = spare_helpers();
+        size_t available = spare.load();
+        while (available > 0 && !spare.compare_exchange_weak(available, available - std::min(available, wanted))) {}
+        return std::min(available, wanted);
+    }
+
+    // The `demand` lightest free cars of every request, lightest first
+    std::vector<std::vector<Candidate>> find_candidates(const std::vector<AllocationRequest>& requests,
+                                                        size_t demand) const {
+        size_t chunks = std::max<size_t>(1, (fleet.slot_count() + CHUNK_SLOTS - 1) / CHUNK_SLOTS);
+        size_t tasks = requests.size() * chunks;
+        std::vector<std::vector<Candidate>> found(tasks);
+        std::atomic<size_t> next{0};
+
+        auto work = [&]() {
+            for (size_t task = next++; task < tasks; task = next++) {
+                const AllocationRequest& request = requests[task / chunks];
+                size_t first = task % chunks * CHUNK_SLOTS;
+                std::vector<Quote> priced =
+                    fleet.priced_matches(request.cars, request.hours, request.budget_cents, first, first + CHUNK_SLOTS);
+                std::vector<Candidate> heap;
+                heap.reserve(priced.size());
+                for (const Quote& quote : priced) heap.push_back(Candidate{weight_of(request, quote), quote.cents, quote.slot, 0});
+
+                // Lightest first, checking calendars only until enough are free
+                auto heavier = [](const Candidate& a, const Candidate& b) { return b < a; };
+                std::make_heap(heap.begin(), heap.end(), heavier);
+                std::vector<Candidate>& kept = found[task];
+                while (!heap.empty() && kept.size() < demand) {
+                    std::pop_heap(heap.begin(), heap.end(), heavier);
+                    const Candidate& lightest = heap.back();
+                    if (fleet.is_free(lightest.slot, request.cars.start, request.cars.end)) kept.push_back(lightest);
+                    heap.pop_back();
+                }
+            }
+        };
+        size_t helpers = take_helpers(tasks - 1);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < helpers; ++i) threads.emplace_back(work);
+        work();
+        for (auto& thread : threads) thread.join();
+        spare_helpers().fetch_add(helpers);
+
+        // Merge the chunks and number the cars
+        std::vector<std::vector<Candidate>> merged(requests.size());
+        std::unordered_map<size_t, uint32_t> car_of;
+        for (size_t r = 0; r < requests.size(); ++r) {
+            std::vector<Candidate>& list = merged[r];
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                std::vector<Candidate>& part = found[r * chunks + chunk];
+                list.insert(list.end(), part.begin(), part.end());
+            }
+            std::sort(list.begin(), list.end());
+            if (list.size() > demand) list.resize(demand);
+            for (Candidate& candidate : list) {
+                candidate.car = car_of.emplace(candidate.slot, static_cast<uint32_t>(car_of.size())).first->second;
+            }
+        }
+        return merged;
+    }
+
+    void assign(const std::vector<AllocationRequest>& requests, const std::vector<std::vector<Candidate>>& candidates,
+                size_t demand, AllocationPlan& plan) const {
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        const size_t count = requests.size();
+        const size_t source = count, sink = count + 1;
+        size_t cars = 0;
+        for (const auto& list : candidates) {
+            for (const Candidate& candidate : list) cars = std::max<size_t>(cars, candidate.car + 1);
+        }
+
+        std::vector<size_t> owner(cars, npos);          // Request holding each car
+        std::vector<const Candidate*> held(cars);       // ...and its candidate entry
+        std::vector<size_t> filled(count, 0);
+        std::vector<long long> potential(count + 2, 0);
+        std::vector<long long> dist(count + 2);
+        std::vector<size_t> prev(count + 2);
+        std::vector<const Candidate*> via(count + 2);   // Car taken to reach each node
+        using Entry = std::pair<long long, size_t>;
+
+        for (size_t unit = 0; unit < demand; ++unit) {
+            std::fill(dist.begin(), dist.end(), INF);
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+            auto relax = [&](size_t from, size_t to, long long cost, const Candidate* car) {
+                long long next = dist[from] + cost + potential[from] - potential[to];
+                if (next >= dist[to]) return;
+                dist[to] = next;
+                prev[to] = from;
+                via[to] = car;
+                queue.push(Entry{next, to});
+            };
+            dist[source] = 0;
+            queue.push(Entry{0, source});
+            while (!queue.empty()) {
+                auto [d, node] = queue.top();
+                queue.pop();
+                if (d > dist[node]) continue;
+                if (node == sink) break;
+                if (node == source) {
+                    for (size_t r = 0; r < count; ++r) {
+                        if (filled[r] < requests[r].count) relax(source, r, 0, nullptr);
+                    }
+                    continue;
+                }
+                bool to_sink = false;
+                for (const Candidate& candidate : candidates[node]) {
+                    size_t holder = owner[candidate.car];
+                    if (holder == npos) {
+                        if (!to_sink) relax(node, sink, candidate.weight, &candidate); // Lightest free car
+                        to_sink = true;
+                    } else if (holder != node) {
+                        relax(node, holder, candidate.weight - held[candidate.car]->weight, &candidate);
+                    }
+                }
+            }
+            if (dist[sink] >= INF) {
+                for (size_t r = 0; r < count; ++r) {
+                    if (filled[r] < requests[r].count) {
+                        plan.unfilled = r;
+                        break;
+                    }
+                }
+                return;
+            }
+            for (size_t node = 0; node < count + 2; ++node) {
+                potential[node] += std::min(dist[node], dist[sink]) - dist[sink];
+            }
+
+            // Walk back from the sink: every request on the path takes the car
+            // it was reached through from the next one
+            for (size_t node = sink; node != source;) {
+                size_t from = prev[node];
+                if (from == source) {
+                    filled[node]++;
+                    break;
+                }
+                owner[via[node]->car] = from;
+                held[via[node]->car] = via[node];
+                node = from;
+            }
+        }
+
+        for (size_t car = 0; car < cars; ++car) {
+            if (owner[car] == npos) continue;
+            plan.cars.push_back(Allocation{owner[car], held[car]->slot, held[car]->cents, std::string()});
+            plan.total_cents += held[car]->cents;
+        }
+        std::sort(plan.cars.begin(), plan.cars.end(), [](const Allocation& a, const Allocation& b) {
+            if (a.request != b.request) return a.request < b.request;
+            return a.cents != b.cents ? a.cents < b.cents : a.slot < b.slot;
+        });
+        plan.complete = true;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    const FleetStore& fleet;
+    AllocationGoal goal;
+};
+
+
+// --- Main Application Class ---
+
+class RentalSystem {
+private:
+    FleetStore fleet;
+    FleetJournal journal;
+    CustomerStore customers;
+    std::vector<UserPassword> users;
+    std::vector<LoadError> load_errors;
+    std::vector<LoadError> sync_warnings;    // Outside edits that were refused; guarded by data_mutex
+
+    // Shared by the rental operations, exclusive for anything that changes the
+    // fleet's structure or the customer list. See FleetStore for per-car claims.
+    mutable std::shared_mutex data_mutex;
+    TransactionLog transaction_log;
+    LogConfig log_config;
+    StatsWriter stats_writer;
+    StatsConfig stats_config;
+    SalesAnalytics analytics;
+
+    // A .txt file that mirrors the in-memory data, as last written or read by us
+    struct TextMirror {
+        std::string name;
+        FileStamp stamp;
+        Fingerprint base;
+    };
+    struct BranchMirror {
+        TextMirror cars;                     // car rental.txt
+        TextMirror available;                // available.txt
+    };
+    std::map<std::string, BranchMirror> fleet_mirrors;
+    std::mutex mirror_mutex;                 // Held while the mirrors are read or written
+    bool mirrors_ready = false;              // Bases are known, so edits can be diffed
+    std::mutex dirty_mutex;                  // Guards the dirty sets
+    std::set<std::string> dirty_car_files;   // Branches whose files need a rewrite
+    std::set<std::string> dirty_available_files;
+    std::mutex reindex_mutex;                // Held while Customer.idx is rebuilt
+    std::vector<std::string> branch_names;   // Main branch first, then the others in order of appearance
+    std::thread sync_thread;
+    std::atomic<bool> sync_running{false};
+    bool sync_warnings_to_stderr = false;    // No console UI to show them (server mode)
+
+    // --- Private Helper Methods ---
+
+    // Safely reads an integer from input
+    int get_numeric_input() {
+        int choice;
+        while (!(std::cin >> choice)) {
+            std::cout << "\n\t | \t\tInvalid input. Please enter a number: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Consume newline
+        return choice;
+    }
+
+    // Securely reads a password from input
+    std::string get_password_input() {
+        std::string password;
+        int ch;
+        ch = read_key();
+        while (ch != 13 && ch != '\n' && ch != EOF) { // 13 is the ASCII for Enter
+            if (ch == '\b' || ch == 127) { // Backspace
+                if (!password.empty()) {
+                    password.pop_back();
+                    std::cout << "\b \b";
+                }
+            } else {
+                password.push_back(static_cast<char>(ch));
+                std::cout << '*';
+            }
+            ch = read_key();
+        }
+        std::cout << std::endl;
+        return password;
+    }
+    
+    // Calculates rental price in cents
+    long long calculate_rate(int hours, const CarView& car) {
+        return price_in_cents(RateSplit(hours), to_cents(car.rate_per_hour), to_cents(car.rate_per_half),
+                              to_cents(car.rate_per_day));
+    }
+
+    // Charge for a car returned after its due time: the price of the hours it
+    // was actually out (a started hour counts in full) less the price of the
+    // hours booked. Early returns are not refunded.
+    long long late_return_fee(const ActiveRental& rental, time_t returned, const CarView& car) {
+        if (returned <= rental.due) return 0;
+        int booked = static_cast<int>((rental.due - rental.start + 3599) / 3600);
+        int used = static_cast<int>((returned - rental.start + 3599) / 3600);
+        return std::max(0LL, calculate_rate(used, car) - calculate_rate(booked, car));
+    }
+    
+    // Displays a list of cars, with a branch column once there is more than one branch
+    static void print_car_header(bool show_branch) {
+        std::cout << "\t  |  Plate Number\tBrand\t Model\t\tCapacity   Colour\t Rate/Hr   Rate/12Hr   Rate/24Hr   Transmission"
+                  << (show_branch ? "   Branch" : "") << std::endl;
+        std::cout << "\t  |  ======================================================================================================================================" << std::endl;
+    }
+
+    static void print_car_row(const CarView& car, bool show_branch) {
+        char line[256];
+        snprintf(line, sizeof(line), "\t  |  %-15s\t%-8s\t %-15s %-10.1f %-10s\t %-10.2f %-10.2f %-10.2f %-10s%s\n",
+                 car.plate_num.data(), car.brand.data(), car.model.data(), car.capacity,
+                 car.colour.data(), car.rate_per_hour, car.rate_per_half, car.rate_per_day,
+                 car.transmission.data(), show_branch ? ("     " + std::string(car.branch)).c_str() : "");
+        std::cout << line;
+    }
+
+    // Scrollable list of the cars passing `base`, a page at a time. Only the rows
+    // on screen are formatted, so opening the list costs the same for any fleet
+    // size. N/P page, / filters as you type, G jumps to a plate, and Enter or Q
+    // closes the list with the last page left on screen.
+    void browse_cars(const std::string& title, const std::function<bool(size_t)>& base) {
+        static const size_t PAGE_ROWS = 20;
+        auto matcher = [this, base](const std::string& text) {
+            return [this, base, text](size_t slot) {
+                if (!fleet.is_live(slot) || !base(slot)) return false;
+                if (text.empty()) return true;
+                CarView car = fleet.at(slot);
+                return contains_ignore_case(car.plate_num, text) || contains_ignore_case(car.brand, text) ||
+                       contains_ignore_case(car.model, text) || contains_ignore_case(car.colour, text);
+            };
+        };
+
+        std::string filter, notice;
+        bool typing = false;
+        bool show_branch = branches().size() > 1;
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        PagedSlotList list(PAGE_ROWS, fleet.slot_count(), matcher(filter));
+        for (;;) {
+            display_art("art.txt");
+            std::cout << "\n\t | \t\t" << title << std::endl;
+            print_car_header(show_branch);
+            std::vector<size_t> page = list.page();
+            for (size_t slot : page) print_car_row(fleet.at(slot), show_branch);
+            if (page.empty()) std::cout << "\t  |  No cars to show." << std::endl;
+
+            std::cout << "\n\t | \t\t";
+            if (list.position_known() && !page.empty()) {
+                std::cout << "Rows " << list.first_row() << "-" << list.first_row() + page.size() - 1;
+                if (list.complete()) std::cout << " of " << list.found();
+            }
+            std::cout << (filter.empty() ? "" : "   Filter: ") << filter << (typing ? "_" : "") << "   " << notice;
+            std::cout << "\n\t | \t\t" << (typing ? "Type to filter, Enter to finish"
+                                                 : "[N]ext  [P]rev  [/] Filter  [G]o to plate  [Q]uit");
+            notice.clear();
+
+            // Nothing is held while waiting for the user
+            lock.unlock();
+            int key = read_key();
+            lock.lock();
+            if (key == EOF) break;
+            if (typing) {
+                if (key == 13 || key == '\n' || key == 27) {
+                    typing = false;
+                } else if ((key == '\b' || key == 127) && !filter.empty()) {
+                    filter.pop_back();
+                    list.set_filter(matcher(filter), false);
+                } else if (key >= 32 && key < 127) {
+                    filter += static_cast<char>(key);
+                    list.set_filter(matcher(filter), true);
+                }
+                continue;
+            }
+            key = std::tolower(key);
+            if (key == 'q' || key == 13 || key == '\n' || key == 27) break;
+            if (key == 'n' || key == ' ') {
+                if (!list.next()) notice = "(last page)";
+            } else if (key == 'p') {
+                if (!list.prev()) notice = "(first page)";
+            } else if (key == '/') {
+                typing = true;
+            } else if (key == 'g') {
+                std::string plate;
+                std::cout << "\n\t | \t\tPlate number: ";
+                lock.unlock();
+                std::getline(std::cin, plate);
+                lock.lock();
+                size_t slot = fleet.find(plate);
+                if (slot == FleetStore::npos) notice = "(no car " + plate + ")";
+                else list.jump(slot);
+            }
+        }
+    }
+
+    void display_car_list() {
+        browse_cars("ALL CARS", [](size_t) { return true; });
+    }
+
+    // Lists the cars that can be booked for [start, end)
+    void display_free_cars(time_t start, time_t end) {
+        browse_cars("CARS AVAILABLE FOR " + std::to_string((end - start) / 3600) + " HOURS", [this, start, end](size_t slot) { return fleet.is_free(slot, start, end); });
+    }
+
+
+    // Journal size at which the fleet files are rewritten and the journal emptied
+    static const size_t JOURNAL_COMPACT_THRESHOLD = 4096;
+
+    // How far before the call a rental may start, for clients whose "now" is a
+    // little behind ours
+    static const time_t START_SLACK = 60;
+
+    // Copies the quoted cars out of the fleet. Needs data_mutex held.
+    std::vector<QuotedCar> copy_quoted(const std::vector<Quote>& quotes) const {
+        std::vector<QuotedCar> rows;
+        rows.reserve(quotes.size());
+        for (const Quote& quote : quotes) {
+            CarView car = fleet.at(quote.slot);
+            rows.push_back(QuotedCar{car.to_car(), std::string(car.branch), quote.cents});
+        }
+        return rows;
+    }
+
+    // Journals a change; the snapshot is only rewritten on compaction
+    void record_change(const std::string& record) {
+        journal.append(record);
+    }
+
+    // Journals changes that are replayed all together or not at all
+    void record_changes(const std::vector<std::string>& records) {
+        journal.append_group(records);
+    }
+
+    // Books every car of `plan` for `cust`, or none if any of them is no
+    // longer free or its slot now holds another car. Needs the exclusive lock.
+    bool book_allocation(const Customer& cust, const std::vector<AllocationRequest>& requests,
+                         const AllocationPlan& plan, const std::vector<std::string>& plates,
+                         std::vector<TransactionRecord>& sales) {
+        time_t now = time(0);
+        auto reservation_of = [&](const Allocation& car) {
+            const CarQuery& window = requests[car.request].cars;
+            return Reservation{window.start, window.end, cust.id};
+        };
+        std::vector<std::string> records;
+        size_t booked = 0;
+        for (; booked < plan.cars.size(); ++booked) {
+            const Allocation& car = plan.cars[booked];
+            Reservation reservation = reservation_of(car);
+            bool starts_now = reservation.start <= now;
+            if (fleet.find(plates[booked]) != car.slot) break;
+            if (!(starts_now ? fleet.hand_over(car.slot, reservation, now) : fleet.book(car.slot, reservation, now))) break;
+            records.push_back((starts_now ? "O " : "B ") + plates[booked] + " " +
+                              std::to_string(static_cast<long long>(reservation.start)) + " " +
+                              std::to_string(static_cast<long long>(reservation.end)) + " " + std::to_string(cust.id));
+        }
+        if (booked < plan.cars.size()) {
+            while (booked-- > 0) {
+                Reservation reservation = reservation_of(plan.cars[booked]);
+                fleet.cancel_booking(plan.cars[booked].slot, reservation, reservation.start <= now);
+            }
+            return false;
+        }
+        record_changes(records);
+
+        for (size_t i = 0; i < plan.cars.size(); ++i) {
+            CarView car = fleet.at(plan.cars[i].slot);
+            sales.push_back(TransactionRecord{now, cust.id, cust.name, plates[i], std::string(car.brand),
+                                              std::string(car.model), requests[plan.cars[i].request].hours,
+                                              plan.cars[i].cents});
+        }
+        return true;
+    }
+
+    // --- Text File Sync ---
+    // Each branch's car rental.txt and available.txt mirror the in-memory
+    // fleet. Changes only mark them dirty; they are rewritten by
+    // flush_text_files, which the sync thread runs every few seconds and
+    // shutdown runs once more. Once the sync thread has written them, edits
+    // other programs make to the files are read back and applied to memory as
+    // a diff against the version we last wrote. Customer.txt is not a mirror
+    // but the customer store itself (see CustomerStore); outside appends to it
+    // are read in, and any other edit rebuilds Customer.idx.
+
+    static constexpr std::chrono::milliseconds TEXT_SYNC_INTERVAL{2000};
+
+    // Marks a branch's files as out of date
+    void mark_dirty(const std::string& branch, bool cars, bool available) {
+        std::lock_guard<std::mutex> lock(dirty_mutex);
+        if (cars) dirty_car_files.insert(branch);
+        if (available) dirty_available_files.insert(branch);
+    }
+
+    // Marks every branch's files as out of date. Needs data_mutex.
+    void mark_all_dirty(bool cars, bool available) {
+        for (const std::string& branch : branch_names) mark_dirty(branch, cars, available);
+    }
+
+    // Writes the dirty files. Picks up outside edits first so they are not
+    // overwritten. Also folds the customers added since Customer.idx was built
+    // into a new index once there are enough of them.
+    void flush_text_files() {
+        {
+            std::lock_guard<std::mutex> guard(mirror_mutex);
+            if (mirrors_ready) apply_external_changes_locked();
+            std::set<std::string> car_files, available_files;
+            {
+                std::lock_guard<std::mutex> lock(dirty_mutex);
+                car_files.swap(dirty_car_files);
+                available_files.swap(dirty_available_files);
+            }
+            if (!write_fleet_mirrors(car_files, available_files)) {
+                for (const std::string& branch : car_files) mark_dirty(branch, true, false);
+                for (const std::string& branch : available_files) mark_dirty(branch, false, true);
+            }
+        }
+        maybe_reindex_customers();
+    }
+
+    BranchMirror& mirror_for(const std::string& branch) {
+        auto it = fleet_mirrors.find(branch);
+        if (it != fleet_mirrors.end()) return it->second;
+        BranchMirror mirror{TextMirror{branch_path(branch, "car rental.txt"), {}, {}},
+                            TextMirror{branch_path(branch, "available.txt"), {}, {}}};
+        return fleet_mirrors.emplace(branch, std::move(mirror)).first->second;
+    }
+
+    // Rewrites the given branches' files in one pass over the fleet
+    bool write_fleet_mirrors(const std::set<std::string>& car_files, const std::set<std::string>& available_files) {
+        struct Output {
+            std::string text;
+            Fingerprint base;
+            size_t count = 0;
+
+            void add(const CarView& car, const std::string& record, uint64_t hash) {
+                if (count > 0) text += "\n";
+                text += record;
+                base.add(record_key(car.plate_num), hash, count++);
+            }
+        };
+        if (car_files.empty() && available_files.empty()) return true;
+        std::map<std::string, Output, std::less<>> cars_out, available_out;
+        for (const std::string& branch : car_files) cars_out[branch];
+        for (const std::string& branch : available_files) available_out[branch];
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            std::ostringstream line;
+            fleet.for_each(false, [&](size_t slot, const CarView& car) {
+                auto cars_it = cars_out.find(car.branch);
+                auto available_it = fleet.in_service(slot) ? available_out.find(car.branch) : available_out.end();
+                if (cars_it == cars_out.end() && available_it == available_out.end()) return;
+                line.str("");
+                write_car_record(line, car);
+                std::string record = line.str();
+                if (cars_it != cars_out.end()) cars_it->second.add(car, record, fnv1a(record.data(), record.size()));
+                if (available_it != available_out.end()) available_it->second.add(car, record, 0);
+            });
+        }
+        bool ok = true;
+        for (auto& entry : cars_out) ok = write_mirror(mirror_for(entry.first).cars, entry.second.text, entry.second.base) && ok;
+        for (auto& entry : available_out) {
+            ok = write_mirror(mirror_for(entry.first).available, entry.second.text, entry.second.base) && ok;
+        }
+        return ok;
+    }
+
+    static bool write_mirror(TextMirror& file, const std::string& text, Fingerprint& base) {
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(file.name).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+        if (!replace_file(file.name, text)) return false;
+        base.seal();
+        file.base = std::move(base);
+        file.stamp = file_stamp(file.name);
+        return true;
+    }
+
+    // Writes through a temporary file so a crash never leaves a truncated file
+    static bool replace_file(const std::string& path, const std::string& text) {
+        ScopedTimer timer(Metric::SAVE_FILE);
+        std::string temp_name = path + ".tmp";
+        {
+            std::ofstream file(temp_name, std::ios::binary);
+            file << text;
+            if (!file) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_name, path, ec);
+        return !ec;
+    }
+
+    void apply_external_changes() {
+        std::lock_guard<std::mutex> guard(mirror_mutex);
+        if (mirrors_ready) apply_external_changes_locked();
+    }
+
+    // Branch directories that appeared since the last look start with an empty
+    // base, so all their cars are picked up
+    void apply_external_changes_locked() {
+        for (const std::string& branch : branch_directories()) mirror_for(branch);
+        bool changed = apply_fleet_file_changes();
+        refresh_customers();
+        if (changed) maybe_compact();
+    }
+
+    // Reads a mirror that changed on disk and diffs it against its base. Returns
+    // false if it is unchanged, missing (`missing` is set) or unreadable (then
+    // it is retried after the next edit).
+    template <typename Record, typename Key, typename Hash>
+    bool read_external_change(TextMirror& file, const char* (*parse)(std::string_view, Record&), Key key, Hash hash,
+                              std::vector<Record>& records, std::vector<uint32_t>& changed, std::vector<uint64_t>& removed,
+                              bool& missing) {
+        FileStamp now = file_stamp(file.name);
+        missing = false;
+        if (now == file.stamp) return false;
+        file.stamp = now;
+        if (!now.exists) {
+            missing = true;
+            return false;
+        }
+        std::vector<LoadError> errors;
+        records = load_records_parallel<Record>(file.name, parse, errors);
+        if (!errors.empty()) return false;
+        Fingerprint current;
+        for (size_t i = 0; i < records.size(); ++i) current.add(key(records[i]), hash(records[i]), i);
+        current.seal();
+        file.base.diff(current, changed, removed);
+        file.base = std::move(current);
+        return !changed.empty() || !removed.empty();
+    }
+
+    // Plates of the cars in `branch` whose record_key is in `keys`. Needs data_mutex.
+    std::vector<std::string> plates_with_keys(const std::vector<uint64_t>& keys, std::string_view branch) const {
+        std::vector<std::string> plates;
+        if (keys.empty()) return plates;
+        std::unordered_set<uint64_t> wanted(keys.begin(), keys.end());
+        fleet.for_each(false, [&](size_t, const CarView& car) {
+            if (car.branch == branch && wanted.count(record_key(car.plate_num))) plates.emplace_back(car.plate_num);
+        });
+        return plates;
+    }
+
+    // Applies edits to every branch's car rental.txt, then available.txt. All
+    // additions are applied before any removal, so a car cut from one branch's
+    // file and pasted into another's is moved with its bookings. A rented car
+    // is neither deleted nor taken out of service, and a car with upcoming
+    // bookings is not deleted: the edit is reported in sync_warnings and its
+    // line written back.
+    bool apply_fleet_file_changes() {
+        struct Change {
+            std::string branch;
+            std::vector<Car> cars;
+            std::vector<uint32_t> changed;
+            std::vector<uint64_t> removed;
+        };
+        auto plate_key = [](const Car& car) { return record_key(car.plate_num); };
+        std::vector<Change> car_changes, available_changes;
+        for (auto& entry : fleet_mirrors) {
+            for (bool available : {false, true}) {
+                Change change{entry.first, {}, {}, {}};
+                bool missing;
+                TextMirror& file = available ? entry.second.available : entry.second.cars;
+                bool found = available ? read_external_change(file, parse_car_line, plate_key, [](const Car&) { return uint64_t(0); },
+                                                              change.cars, change.changed, change.removed, missing)
+                                       : read_external_change(file, parse_car_line, plate_key,
+                                                              [](const Car& car) { return record_hash(car, write_car_record<Car>); },
+                                                              change.cars, change.changed, change.removed, missing);
+                if (missing) mark_dirty(entry.first, !available, available); // Recreate it
+                if (found) (available ? available_changes : car_changes).push_back(std::move(change));
+            }
+        }
+        if (car_changes.empty() && available_changes.empty()) return false;
+
+        std::unique_lock<std::shared_mutex> lock(data_mutex);
+        for (const Change& change : car_changes) {
+            note_branch(change.branch);
+            for (uint32_t i : change.changed) {
+                const Car& car = change.cars[i];
+                size_t slot = fleet.find(car.plate_num);
+                if (slot == FleetStore::npos) {
+                    fleet.add(car, true, change.branch);
+                    record_change(journal_car('A', car, change.branch));
+                } else {
+                    std::string from(fleet.at(slot).branch);
+                    fleet.update(slot, car);
+                    record_change(journal_car('U', car, from));
+                    if (from != change.branch) {
+                        fleet.move(slot, change.branch);
+                        record_change("M " + car.plate_num + " " + change.branch);
+                        mark_dirty(from, true, true);
+                    }
+                }
+            }
+            mark_dirty(change.branch, false, true);
+        }
+        time_t now = time(0);
+        for (const Change& change : car_changes) {
+            for (const std::string& plate : plates_with_keys(change.removed, change.branch)) {
+                size_t slot = fleet.find(plate);
+                const char* refusal = fleet.is_rented(slot) ? " is rented and was not deleted; return it first"
+                                      : fleet.has_bookings(slot, now) ? " has upcoming bookings and was not deleted"
+                                                                      : nullptr;
+                if (refusal) {
+                    sync_warnings.push_back(LoadError{branch_path(change.branch, "car rental.txt"), 0, plate + refusal});
+                    mark_dirty(change.branch, true, true);
+                    continue;
+                }
+                fleet.remove(plate);
+                record_change("D " + plate);
+            }
+        }
+        for (const Change& change : available_changes) {
+            for (uint32_t i : change.changed) {
+                size_t slot = fleet.find(change.cars[i].plate_num);
+                if (slot == FleetStore::npos || fleet.at(slot).branch != change.branch || fleet.in_service(slot)) continue;
+                fleet.set_in_service(slot, true);
+                record_change("T " + change.cars[i].plate_num);
+            }
+            for (const std::string& plate : plates_with_keys(change.removed, change.branch)) {
+                size_t slot = fleet.find(plate);
+                if (!fleet.in_service(slot)) continue;
+                if (!fleet.set_in_service(slot, false)) {
+                    sync_warnings.push_back(LoadError{branch_path(change.branch, "available.txt"), 0,
+                                                      plate + " is rented and stays in service; return it first"});
+                    mark_dirty(change.branch, false, true);
+                    continue;
+                }
+                record_change("R " + plate);
+            }
+        }
+        return true;
+    }
+
+    // Reads customers other programs appended to Customer.txt. After any other
+    // edit the index is rebuilt, without holding data_mutex while it is built.
+    // Lines that cannot be used are skipped, as in the other files.
+    void refresh_customers() {
+        CustomerStore::Change change;
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            change = customers.external_change();
+        }
+        if (change == CustomerStore::Change::APPENDED) {
+            std::vector<LoadError> errors;
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            customers.read_appended(errors);
+        } else if (change == CustomerStore::Change::REWRITTEN) {
+            reindex_customers();
+        }
+    }
+
+    // Rebuilds Customer.idx if enough customers were added since it was built
+    void maybe_reindex_customers() {
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            if (!customers.needs_rebuild()) return;
+        }
+        reindex_customers();
+    }
+
+    void reindex_customers() {
+        std::unique_lock<std::mutex> guard(reindex_mutex, std::try_to_lock);
+        if (!guard.owns_lock()) return; // Another thread is already at it
+        std::vector<LoadError> errors;
+        if (!customers.build_index(errors)) return;
+        std::unique_lock<std::shared_mutex> lock(data_mutex);
+        customers.adopt_index(errors);
+    }
+
+    // Writes every mirror once so the bases are known, then watches the files
+    // and flushes changes every `interval` until stop_file_sync()
+    void sync_files(std::chrono::milliseconds interval) {
+        static const std::chrono::milliseconds POLL_INTERVAL(250);
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            mark_all_dirty(true, true);
+        }
+        flush_text_files();
+        {
+            std::lock_guard<std::mutex> guard(mirror_mutex);
+            mirrors_ready = true;
+        }
+        FileWatcher watcher({"car rental.txt", "available.txt", "Customer.txt"});
+        auto next_flush = std::chrono::steady_clock::now() + interval;
+        while (sync_running.load(std::memory_order_relaxed)) {
+            watcher.watch(BRANCH_ROOT);
+            for (const std::string& branch : branch_directories()) watcher.watch(BRANCH_ROOT + ("/" + branch));
+            if (watcher.wait(POLL_INTERVAL)) apply_external_changes();
+            if (sync_warnings_to_stderr) {
+                for (const LoadError& warning : take_sync_warnings()) {
+                    std::cerr << warning.file << ": " << warning.message << std::endl;
+                }
+            }
+            if (std::chrono::steady_clock::now() >= next_flush) {
+                flush_text_files();
+                next_flush = std::chrono::steady_clock::now() + interval;
+            }
+        }
+    }
+
+    // Compacts once the journal is long enough. Must be called without holding
+    // data_mutex, since compaction needs exclusive access.
+    void maybe_compact() {
+        if (journal.record_count() < JOURNAL_COMPACT_THRESHOLD) return;
+        std::unique_lock<std::shared_mutex> lock(data_mutex);
+        if (journal.record_count() >= JOURNAL_COMPACT_THRESHOLD) compact_fleet_files();
+    }
+
+
+public:
+    RentalSystem() {
+        // Seed random number generator
+        srand(time(0));
+    }
+
+    ~RentalSystem() { stop_file_sync(); }
+
+    // --- Data Loading and Saving ---
+
+    // Opens the customer store, loads fleet.snap when present (otherwise the
+    // fleet's text files), and then replays the journal on top. A snapshot
+    // that fails validation is kept as fleet.snap.bad. The journal only holds
+    // the changes since that snapshot, so it is kept as fleet.journal.bad
+    // rather than replayed over the text files. Returns false without touching
+    // anything if fleet.snap was written by a newer version.
+    bool load_all_data() {
+        load_errors.clear();
+        if (snapshot_is_newer("fleet.snap")) {
+            load_errors.push_back(LoadError{"fleet.snap", 0, "written by a newer version; not loaded or overwritten"});
+            return false;
+        }
+        load_customers();
+        bool from_snapshot = std::filesystem::exists("fleet.snap");
+        bool migrated = false;
+        if (from_snapshot) {
+            ScopedTimer timer(Metric::LOAD_SNAPSHOT);
+            std::vector<Customer> loaded;
+            if (const char* error = load_snapshot("fleet.snap", fleet, loaded)) {
+                set_aside("fleet.snap", error);
+                from_snapshot = false;
+            } else {
+                // Snapshots written before Customer.idx existed still hold the customers
+                for (const Customer& cust : loaded) customers.insert(cust);
+                customers.write_pending();
+                migrated = !loaded.empty();
+            }
+        }
+        if (!from_snapshot) {
+            load_fleet_files();
+            std::error_code ec;
+            if (std::filesystem::file_size("fleet.journal", ec) > 0 && !ec) {
+                set_aside("fleet.journal", "was written against fleet.snap and not replayed over the .txt files");
+            }
+        }
+        replay_journal();
+        load_users();
+        if (!from_snapshot || migrated) compact_fleet_files();
+        transaction_log.start(log_config);
+        stats_writer.start(stats_config);
+        return true;
+    }
+
+    // Renames a data file that cannot be used to <path>.bad, so it is never
+    // overwritten, and reports why
+    void set_aside(const std::string& path, const std::string& reason) {
+        std::error_code ec;
+        std::filesystem::rename(path, path + ".bad", ec);
+        load_errors.push_back(LoadError{path, 0, reason + (ec ? "" : "; kept as " + path + ".bad")});
+    }
+
+    void configure_log(const LogConfig& config) { log_config = config; }
+    // Tracing starts here, so loading the data shows up in the trace
+    void configure_stats(const StatsConfig& config) {
+        stats_config = config;
+        if (!config.trace_file.empty()) Metrics::start_trace();
+    }
+
+    // Loads every branch's files, one thread per branch (each of which splits
+    // its files further; see load_records_parallel), then adds the cars in
+    // branch order. Cars start out unavailable until the branch's available.txt
+    // lists them; it keeps full car records for compatibility, but only the
+    // plate is used.
+    void load_fleet_files() {
+        struct BranchFiles {
+            std::string name;
+            std::vector<Car> cars, available;
+            std::vector<LoadError> errors;
+        };
+        std::vector<BranchFiles> loaded;
+        loaded.push_back(BranchFiles{MAIN_BRANCH, {}, {}, {}});
+        for (const std::string& branch : branch_directories()) loaded.push_back(BranchFiles{branch, {}, {}, {}});
+        auto load_branch = [](BranchFiles& files) {
+            {
+                ScopedTimer timer(Metric::LOAD_CAR_FILE);
+                files.cars = load_records_parallel<Car>(branch_path(files.name, "car rental.txt"), parse_car_line, files.errors);
+            }
+            ScopedTimer timer(Metric::LOAD_AVAILABLE_FILE);
+            files.available = load_records_parallel<Car>(branch_path(files.name, "available.txt"), parse_car_line, files.errors);
+        };
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < loaded.size(); ++i) workers.emplace_back(load_branch, std::ref(loaded[i]));
+        load_branch(loaded[0]);
+        for (auto& worker : workers) worker.join();
+
+        fleet.clear();
+        branch_names.clear();
+        for (BranchFiles& files : loaded) {
+            note_branch(files.name);
+            for (const Car& car : files.cars) {
+                if (fleet.add(car, false, files.name) == FleetStore::npos) {
+                    files.errors.push_back(LoadError{branch_path(files.name, "car rental.txt"), 0,
+                                                     "duplicate plate " + car.plate_num});
+                }
+            }
+            for (const Car& car : files.available) {
+                size_t slot = fleet.find(car.plate_num);
+                if (slot != FleetStore::npos && fleet.at(slot).branch == files.name) fleet.set_in_service(slot, true);
+            }
+            load_errors.insert(load_errors.end(), files.errors.begin(), files.errors.end());
+        }
+    }
+
+    // Records a branch in use, so its files are written and it shows up in lists
+    void note_branch(std::string_view branch) {
+        if (std::find(branch_names.begin(), branch_names.end(), branch) == branch_names.end()) {
+            branch_names.emplace_back(branch);
+        }
+    }
+
+    // Main branch, then the branch directories, then branches only the fleet knows
+    void collect_branches() {
+        branch_names.clear();
+        note_branch(MAIN_BRANCH);
+        for (const std::string& branch : branch_directories()) note_branch(branch);
+        for (std::string_view branch : fleet.branch_list()) note_branch(branch);
+    }
+
+    // Journal record for adding or updating a car; the branch is left off for
+    // the main branch, as in journals written before there were branches
+    static std::string journal_car(char op, const Car& car, std::string_view branch) {
+        std::ostringstream record;
+        record << op << ' ';
+        write_car_record(record, car);
+        if (branch != MAIN_BRANCH) record << ' ' << branch;
+        return record.str();
+    }
+    
+    // Applies the changes recorded since car rental.txt/available.txt were written.
+    // Replay is idempotent, so a crash half way through a compaction is harmless.
+    void replay_journal() {
+        ScopedTimer timer(Metric::REPLAY_JOURNAL);
+        size_t replayed = journal.replay("fleet.journal", [this](char op, const std::string& args) {
+            std::istringstream in(args);
+            Car car;
+            Customer cust;
+            size_t slot;
+            std::string branch;
+            switch (op) {
+                case 'A':
+                    if (read_car_record(in, car)) {
+                        if (!(in >> branch)) branch = MAIN_BRANCH;
+                        fleet.add(car, true, branch);
+                    }
+                    break;
+                case 'U':
+                    if (read_car_record(in, car)) {
+                        if (!(in >> branch)) branch = MAIN_BRANCH;
+                        slot = fleet.find(car.plate_num);
+                        if (slot != FleetStore::npos) fleet.update(slot, car);
+                        else fleet.add(car, true, branch);
+                    }
+                    break;
+                case 'M': {
+                    std::string plate;
+                    if (in >> plate >> branch) {
+                        slot = fleet.find(plate);
+                        if (slot != FleetStore::npos) fleet.move(slot, branch);
+                    }
+                    break;
+                }
+                case 'D':
+                    fleet.remove(args);
+                    break;
+                case 'K': {
+                    std::string plate;
+                    long long start = 0;
+                    if (in >> plate >> start) {
+                        slot = fleet.find(plate);
+                        if (slot != FleetStore::npos) fleet.calendar(slot).cancel(static_cast<time_t>(start));
+                    }
+                    break;
+                }
+                case 'R':
+                case 'T':
+                    slot = fleet.find(args);
+                    if (slot != FleetStore::npos) fleet.set_in_service(slot, op == 'T');
+                    break;
+                case 'B':
+                case 'O': {
+                    std::string plate;
+                    Reservation reservation;
+                    long long start, end;
+                    if (in >> plate >> start >> end >> reservation.customer_id) {
+                        slot = fleet.find(plate);
+                        reservation.start = static_cast<time_t>(start);
+                        reservation.end = static_cast<time_t>(end);
+                        if (slot != FleetStore::npos) {
+                            fleet.calendar(slot).book(reservation);
+                            if (op == 'O') fleet.restore_rental(slot, reservation);
+                        }
+                    }
+                    break;
+                }
+                case 'I': {
+                    std::string plate;
+                    long long returned;
+                    ActiveRental ended;
+                    if (in >> plate >> returned) {
+                        slot = fleet.find(plate);
+                        if (slot != FleetStore::npos) fleet.take_back(slot, static_cast<time_t>(returned), ended);
+                    }
+                    break;
+                }
+                case 'E': {
+                    std::string plate;
+                    long long start, end;
+                    if (in >> plate >> start >> end) {
+                        slot = fleet.find(plate);
+                        if (slot != FleetStore::npos) {
+                            fleet.calendar(slot).shorten(static_cast<time_t>(start), static_cast<time_t>(end));
+                        }
+                    }
+                    break;
+                }
+                case 'X':
+                    fleet.make_all_available();
+                    fleet.clear_reservations();
+                    break;
+                case 'C':
+                    // Older journals recorded new customers; Customer.txt holds them now
+                    if (!parse_customer_line(args, cust)) customers.insert(cust);
+                    break;
+            }
+        });
+        customers.write_pending();
+        journal.open("fleet.journal");
+        collect_branches();
+        // The text files may not have caught up with these changes
+        if (replayed > 0) mark_all_dirty(true, true);
+    }
+
+    // Maps Customer.idx instead of reading Customer.txt; see Customer Store
+    void load_customers(bool rebuild = false) {
+        ScopedTimer timer(Metric::LOAD_CUSTOMER_FILE);
+        customers.open(load_errors, rebuild);
+    }
+
+    void load_users() {
+        ScopedTimer timer(Metric::LOAD_USER_FILE);
+        std::ifstream file("UserPass.txt");
+        users.clear();
+        UserPassword temp_user;
+        while(file >> temp_user.id >> temp_user.password) {
+            users.push_back(temp_user);
+        }
+        file.close();
+    }
+    
+    // Writes one branch's cars to a temporary file first so a crash never
+    // leaves a truncated file
+    void save_data_to_file(const std::string& filename, bool available_only, std::string_view branch = MAIN_BRANCH) {
+        ScopedTimer timer(Metric::SAVE_FILE);
+        std::string temp_name = filename + ".tmp";
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(filename).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+        std::ofstream file(temp_name);
+        bool first = true;
+        fleet.for_each(available_only, [&](size_t, const CarView& car) {
+            if (car.branch != branch) return;
+            if (!first) file << "\n";
+            write_car_record(file, car);
+            first = false;
+        });
+        file.close();
+        std::filesystem::rename(temp_name, filename, ec);
+    }
+
+    // Folds the journal into a fresh fleet.snap. Customers live in
+    // Customer.txt, so the snapshot no longer carries them. Strings no car
+    // uses any more are dropped from the fleet's pool first. Needs the
+    // exclusive lock.
+    void compact_fleet_files() {
+        ScopedTimer timer(Metric::SAVE_SNAPSHOT);
+        journal.sync();
+        customers.write_pending();
+        fleet.compact_strings();
+        if (write_snapshot("fleet.snap", fleet)) {
+            journal.truncate();
+        }
+    }
+
+    // --- Text Import/Export ---
+
+    // Replaces the snapshot with the contents of the .txt files. Returns false
+    // without touching anything if fleet.snap was written by a newer version.
+    bool import_text() {
+        load_errors.clear();
+        if (snapshot_is_newer("fleet.snap")) {
+            load_errors.push_back(LoadError{"fleet.snap", 0, "written by a newer version; not overwritten"});
+            return false;
+        }
+        load_fleet_files();
+        load_customers(true);
+        load_users();
+        journal.open("fleet.journal");
+        compact_fleet_files();
+        return true;
+    }
+
+    // Writes the current state back out in the .txt formats
+    void export_text() {
+        for (const std::string& branch : branch_names) {
+            save_data_to_file(branch_path(branch, "car rental.txt"), false, branch);
+            save_data_to_file(branch_path(branch, "available.txt"), true, branch);
+        }
+        // Customer.txt is always current
+        customers.write_pending();
+    }
+
+    size_t car_count() const { return fleet.size(); }
+    size_t customer_count() const { return customers.size(); }
+
+    // Bytes held by the fleet's columns, indexes and interned strings
+    size_t fleet_memory_usage() const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return fleet.memory_usage();
+    }
+
+    // Customers held in memory rather than read from Customer.txt on demand
+    size_t resident_customers() const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return customers.resident();
+    }
+    const std::vector<LoadError>& errors() const { return load_errors; }
+
+    // Outside edits to the data files refused since the last call
+    std::vector<LoadError> take_sync_warnings() {
+        std::unique_lock<std::shared_mutex> lock(data_mutex);
+        std::vector<LoadError> taken;
+        taken.swap(sync_warnings);
+        return taken;
+    }
+
+    // Keeps the .txt files in step with memory in the background and applies
+    // edits other programs make to them; see Text File Sync
+    // Starts the sync thread. Refused outside edits are printed to stderr if
+    // `warnings_to_stderr`, otherwise left for take_sync_warnings.
+    void start_file_sync(bool warnings_to_stderr = false, std::chrono::milliseconds interval = TEXT_SYNC_INTERVAL) {
+        if (sync_running.exchange(true)) return;
+        sync_warnings_to_stderr = warnings_to_stderr;
+        sync_thread = std::thread([this, interval] { sync_files(interval); });
+    }
+
+    void stop_file_sync() {
+        if (!sync_running.exchange(false)) return;
+        sync_thread.join();
+    }
+
+    void shutdown() {
+        stop_file_sync();
+        transaction_log.stop();
+        flush_text_files();
+        if (journal.record_count() > 0) compact_fleet_files();
+        journal.close();
+        customers.write_pending();
+        stats_writer.stop();
+    }
+    
+    // --- Rental Operations ---
+    // Business logic behind the menus. None of these touch the console, so they
+    // can be driven by batch mode or other front ends, and all of them are safe
+    // to call from several threads at once.
+
+    // Copies the customer with this ID into `out`. Returns false if there is none.
+    bool find_customer(int id, Customer& out) const {
+        ScopedTimer timer(Metric::CUSTOMER_LOOKUP);
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return customers.find(id, out);
+    }
+
+    // Customers whose name, phone or IC starts with `prefix`, sorted by that field
+    std::vector<Customer> search_customers(CustomerField field, const std::string& prefix, size_t limit) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return customers.search(field, prefix, limit);
+    }
+
+    int next_customer_id() const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return customers.next_id();
+    }
+
+    // Assigns the next customer ID, appends the customer to Customer.txt and
+    // returns the ID
+    int register_customer(Customer cust) {
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            cust.id = customers.add(cust);
+        }
+        customers.write_pending();
+        maybe_reindex_customers();
+        return cust.id;
+    }
+
+    // Books the car for `hours` from `start`, logs the transaction and reports
+    // the price in `total_cost` (cents). A rental starting now also hands the
+    // car over, so it stays rented until return_car; later ones are only
+    // reservations. A start in the past (beyond START_SLACK) is INVALID. Only
+    // the car itself is claimed, so rentals of different cars never wait for
+    // each other. The journal record is written before the claim is released,
+    // so a return of the same car is always journaled after it.
+    OpStatus rent_car(const Customer& cust, const std::string& plate, time_t start, int hours, long long& total_cost) {
+        if (hours <= 0 || start < time(0) - START_SLACK) return OpStatus::INVALID;
+        ScopedTimer total(Metric::RENT_TOTAL);
+        Reservation reservation{start, start + static_cast<time_t>(hours) * 3600, cust.id};
+        std::string brand, model;
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            ScopedTimer lookup(Metric::RENT_LOOKUP);
+            size_t slot = fleet.find(plate);
+            if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+            time_t now = time(0);
+            bool starts_now = start <= now;
+            auto journal_rental = [&]() {
+                ScopedTimer persist(Metric::RENT_PERSIST);
+                record_change((starts_now ? "O " : "B ") + plate + " " + std::to_string(static_cast<long long>(reservation.start)) +
+                              " " + std::to_string(static_cast<long long>(reservation.end)) + " " + std::to_string(cust.id));
+            };
+            if (!(starts_now ? fleet.hand_over(slot, reservation, now, journal_rental)
+                             : fleet.book(slot, reservation, now, journal_rental))) {
+                return OpStatus::NOT_AVAILABLE;
+            }
+            lookup.stop();
+
+            ScopedTimer pricing(Metric::RENT_PRICING);
+            CarView selected_car = fleet.at(slot);
+            total_cost = calculate_rate(hours, selected_car);
+            brand = selected_car.brand;
+            model = selected_car.model;
+        }
+
+        ScopedTimer log(Metric::RENT_LOG);
+        transaction_log.append(TransactionRecord{time(0), cust.id, cust.name, plate, brand, model, hours, total_cost});
+        log.stop();
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Books a bulk request for one customer: every request is filled or
+    // nothing is booked (NOT_AVAILABLE, with plan.unfilled naming a request
+    // that could not be). The cars are chosen by BatchAllocator under the
+    // shared lock, then booked under the exclusive lock and journaled as one
+    // group, so no reader sees part of a batch. If a chosen car was taken in
+    // between, the batch is planned again; the last attempt plans under the
+    // exclusive lock.
+    OpStatus allocate_batch(const Customer& cust, const std::vector<AllocationRequest>& requests,
+                            AllocationGoal goal, AllocationPlan& plan) {
+        static const int ATTEMPTS = 3;
+        plan = AllocationPlan();
+        if (requests.empty()) return OpStatus::INVALID;
+        for (const AllocationRequest& request : requests) {
+            if (request.count == 0 || request.hours <= 0 || request.cars.end <= request.cars.start) {
+                return OpStatus::INVALID;
+            }
+        }
+
+        std::vector<TransactionRecord> sales;
+        std::vector<std::string> plates;
+        auto make_plan = [&]() {
+            ScopedTimer timer(Metric::ALLOCATE_PLAN);
+            plan = BatchAllocator(fleet, goal).plan(requests);
+            plates.clear();
+            for (const Allocation& car : plan.cars) plates.emplace_back(fleet.at(car.slot).plate_num);
+            return plan.complete;
+        };
+        for (int attempt = 1;; ++attempt) {
+            bool last = attempt == ATTEMPTS;
+            if (!last) {
+                std::shared_lock<std::shared_mutex> lock(data_mutex);
+                if (!make_plan()) return OpStatus::NOT_AVAILABLE;
+            }
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            if (last && !make_plan()) return OpStatus::NOT_AVAILABLE;
+            ScopedTimer timer(Metric::ALLOCATE_COMMIT);
+            if (book_allocation(cust, requests, plan, plates, sales)) break;
+        }
+        for (size_t i = 0; i < plan.cars.size(); ++i) plan.cars[i].plate = plates[i];
+
+        for (TransactionRecord& sale : sales) transaction_log.append(std::move(sale));
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Takes the car back now. A rented car is charged `late_fee` (cents; see
+    // late_return_fee), which is logged as a transaction of its own. A
+    // reservation in progress that was never handed over just ends early.
+    OpStatus return_car(const std::string& plate, long long& late_fee) {
+        late_fee = 0;
+        TransactionRecord charge;
+        {
+            std::shared_lock<std::shared_mutex> lock(data_mutex);
+            size_t slot = fleet.find(plate);
+            if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+            time_t now = time(0);
+            ActiveRental rental;
+            auto journal_return = [&]() { record_change("I " + plate + " " + std::to_string(static_cast<long long>(now))); };
+            if (fleet.take_back(slot, now, rental, journal_return)) {
+                CarView car = fleet.at(slot);
+                late_fee = late_return_fee(rental, now, car);
+                if (late_fee > 0) {
+                    Customer cust;
+                    customers.find(rental.customer_id, cust);
+                    int extra_hours = static_cast<int>((now - rental.due + 3599) / 3600);
+                    charge = TransactionRecord{now, rental.customer_id, cust.name, plate, std::string(car.brand),
+                                               std::string(car.model), extra_hours, late_fee};
+                }
+            } else {
+                Reservation ended;
+                auto journal_end = [&]() {
+                    record_change("E " + plate + " " + std::to_string(static_cast<long long>(ended.start)) + " " +
+                                  std::to_string(static_cast<long long>(now)));
+                };
+                if (!fleet.end_booking(slot, now, ended, journal_end)) return OpStatus::NOT_AVAILABLE;
+            }
+        }
+        if (late_fee > 0) transaction_log.append(std::move(charge));
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Takes a car out of service or puts it back. A rented car has to be
+    // returned first.
+    OpStatus set_maintenance(const std::string& plate, bool in_maintenance) {
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            size_t slot = fleet.find(plate);
+            if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+            if (fleet.in_service(slot) != in_maintenance) return OpStatus::OK;
+            if (!fleet.set_in_service(slot, !in_maintenance)) return OpStatus::NOT_AVAILABLE;
+            record_change((in_maintenance ? "R " : "T ") + plate);
+            mark_dirty(std::string(fleet.at(slot).branch), false, true);
+        }
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    OpStatus car_status(const std::string& plate, CarStatus& status) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        size_t slot = fleet.find(plate);
+        if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+        status = fleet.status(slot, time(0));
+        return OpStatus::OK;
+    }
+
+    // Cars currently with a customer, soonest due (so overdue) first. Only the
+    // `limit` rows from `first` on (limit 0 = all) look up their customer.
+    std::vector<RentedCar> rented_cars(size_t first = 0, size_t limit = 0, size_t* total = nullptr) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        std::vector<ActiveRental> rentals = fleet.rentals();
+        if (total) *total = rentals.size();
+        size_t last = limit == 0 ? rentals.size() : std::min(rentals.size(), first + limit);
+        time_t now = time(0);
+        std::vector<RentedCar> rows;
+        for (size_t i = first; i < last; ++i) {
+            const ActiveRental& rental = rentals[i];
+            CarView car = fleet.at(rental.slot);
+            Customer cust;
+            customers.find(rental.customer_id, cust);
+            rows.push_back(RentedCar{std::string(car.plate_num), std::string(car.brand), std::string(car.model),
+                                     std::string(car.branch), rental.customer_id, cust.name, rental.start, rental.due,
+                                     rental.due <= now});
+        }
+        return rows;
+    }
+
+    OpStatus add_car(const Car& car, const std::string& branch = MAIN_BRANCH) {
+        if (car.plate_num.empty() || !valid_branch_name(branch)) return OpStatus::INVALID;
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            if (fleet.add(car, true, branch) == FleetStore::npos) return OpStatus::DUPLICATE;
+            note_branch(branch);
+            record_change(journal_car('A', car, branch));
+            mark_dirty(branch, true, true);
+        }
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Deletes a car. A rented car has to be returned first. A car with
+    // upcoming bookings is only deleted with `force`; the bookings it drops are
+    // journaled together with the deletion.
+    OpStatus remove_car(const std::string& plate, bool force = false) {
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            size_t slot = fleet.find(plate);
+            if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+            if (fleet.is_rented(slot)) return OpStatus::NOT_AVAILABLE;
+            time_t now = time(0);
+            if (fleet.has_bookings(slot, now) && !force) return OpStatus::BOOKED;
+            std::vector<std::string> records;
+            fleet.calendar(slot).for_each([&](const Reservation& booking) {
+                if (booking.end <= now) return;
+                records.push_back("K " + plate + " " + std::to_string(static_cast<long long>(booking.start)) + " " +
+                                  std::to_string(static_cast<long long>(booking.end)) + " " +
+                                  std::to_string(booking.customer_id));
+            });
+            records.push_back("D " + plate);
+            std::string branch(fleet.at(slot).branch);
+            fleet.remove(plate);
+            if (records.size() == 1) record_change(records[0]);
+            else record_changes(records);
+            mark_dirty(branch, true, true);
+        }
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Transfers a car, with its bookings, to another branch
+    OpStatus move_car(const std::string& plate, const std::string& branch) {
+        if (!valid_branch_name(branch)) return OpStatus::INVALID;
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            size_t slot = fleet.find(plate);
+            if (slot == FleetStore::npos) return OpStatus::NOT_FOUND;
+            std::string from(fleet.at(slot).branch);
+            if (from == branch) return OpStatus::OK;
+            fleet.move(slot, branch);
+            note_branch(branch);
+            record_change("M " + plate + " " + branch);
+            mark_dirty(from, true, true);
+            mark_dirty(branch, true, true);
+        }
+        maybe_compact();
+        return OpStatus::OK;
+    }
+
+    // Branches in use, main branch first
+    std::vector<std::string> branches() const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return branch_names;
+    }
+
+    // Puts every car back in service and drops all bookings
+    void reset_availability() {
+        {
+            std::unique_lock<std::shared_mutex> lock(data_mutex);
+            fleet.make_all_available();
+            fleet.clear_reservations();
+            record_change("X");
+            mark_all_dirty(false, true);
+        }
+        maybe_compact();
+    }
+
+    // Prices every car free for `hours` from `start`; see FleetStore::quote_all.
+    // The cars are copied while the lock is held.
+    std::vector<QuotedCar> quote_all(time_t start, int hours, size_t limit, long long budget_cents) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return copy_quoted(fleet.quote_all(start, hours, limit, budget_cents));
+    }
+
+    // Cars matching the query, cheapest first; see FleetStore::query. The cars
+    // are copied while the lock is held.
+    std::vector<QuotedCar> search_cars(const CarQuery& query) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        return copy_quoted(fleet.query(query));
+    }
+
+    // Copies the car with this plate into `out`. Returns false if there is none.
+    bool find_car(const std::string& plate, Car& out) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        size_t slot = fleet.find(plate);
+        if (slot == FleetStore::npos) return false;
+        out = fleet.at(slot).to_car();
+        return true;
+    }
+
+    // Same as quote_all, but returns plate numbers so the result stays valid
+    std::vector<std::pair<std::string, long long>> quote_plates(time_t start, int hours, size_t limit) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        std::vector<std::pair<std::string, long long>> priced;
+        for (const Quote& quote : fleet.quote_all(start, hours, limit, -1)) {
+            priced.emplace_back(fleet.at(quote.slot).plate_num, quote.cents);
+        }
+        return priced;
+    }
+
+    // Plates of every car that can be booked for [start, end), up to `limit` (0 = all)
+    std::vector<std::string> free_cars(time_t start, time_t end, size_t limit = 0) const {
+        std::shared_lock<std::shared_mutex> lock(data_mutex);
+        std::vector<std::string> plates;
+        fleet.for_each_free(start, end, [&plates, limit](size_t, const CarView& car) {
+            if (limit == 0 || plates.size() < limit) plates.emplace_back(car.plate_num);
+        });
+        return plates;
+    }
+
+    
+    // --- Menus ---
+
+    void main_menu() {
+        int choice;
+        do {
+            std::vector<LoadError> refused = take_sync_warnings();
+            if (!refused.empty()) show_file_warnings(refused, "edit(s) to the data files were not applied");
+            display_art("art.txt");
+            std::cout << "\n\n\t |\t\t\t\t\t\t\t  1. ADMIN";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  2. USER";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  3. TERMS & CONDITIONS";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  4. EXIT" << std::endl;
+            std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
+            choice = get_numeric_input();
+            clear_screen();
+
+            switch (choice) {
+                case 1: admin_login(); break;
+                case 2: user_menu(); break;
+                case 3: show_terms_and_conditions(); break;
+                case 4: 
+                    shutdown();
+                    display_art("exit art.txt");
+                    pause_screen(2000);
+                    break;
+                default:
+                    std::cout << "\n\t | \t\tInvalid choice. Please try again.";
+                    press_any_key_to_continue();
+            }
+        } while (choice != 4);
+    }
+    
+    void admin_login() {
+        draw_border();
+        gotoxy(40, 20);
+        std::cout << "\n\n\n\n\t | \t\t\tEnter Password: ";
+        std::string password = get_password_input();
+
+        ScopedTimer timer(Metric::ADMIN_LOGIN);
+        bool logged_in = false;
+        if (password == "a") { // Default/master password
+            logged_in = true;
+        } else {
+            for(const auto& user : users) {
+                if (user.password == password) {
+                    logged_in = true;
+                    break;
+                }
+            }
+        }
+        timer.stop();
+        
+        if (logged_in) {
+            display_loading_bar("LOGGING IN...");
+            admin_menu();
+        } else {
+            std::cout << "\n\t | \t\t\tWrong Password... Returning to Main Menu.";
+            pause_screen(2000);
+            clear_screen();
+        }
+    }
+    
+    void admin_menu() {
+         int choice;
+        do {
+            display_art("art.txt");
+            std::cout << "\n\t |\t\t\t\t\t\t\t  1. ADD NEW ADMIN";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  2. SHOW ALL CAR DATA";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  3. ADD NEW CAR";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  4. DELETE CAR";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  5. RESET AVAILABLE CARS";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  6. SALES REPORT";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  7. MOVE CAR TO BRANCH";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  8. STATISTICS";
+            std::cout << "\n\t |\t\t\t\t\t\t\t  9. RETURN CAR";
+            std::cout << "\n\t |\t\t\t\t\t\t\t 10. RENTED CARS";
+            std::cout << "\n\t |\t\t\t\t\t\t\t 11. CAR MAINTENANCE";
+            std::cout << "\n\t |\t\t\t\t\t\t\t 12. LOG OFF" << std::endl;
+            std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
+            choice = get_numeric_input();
+
+            clear_screen();
+            switch(choice) {
+                case 1: add_new_user(); break;
+                case 2: show_all_car_data(); break;
+                case 3: add_new_car(); break;
+                case 4: delete_car(); break;
+                case 5: reset_available_cars(); break;
+                case 6: sales_report(); break;
+                case 7: move_car_screen(); break;
+                case 8: show_statistics(); break;
+                case 9: return_car_screen(); break;
+                case 10: rented_cars_screen(); break;
+                case 11: maintenance_screen(); break;
+                case 12: display_loading_bar("LOGGING OFF..."); break;
+                default: std::cout << "\n\t | \t\tInvalid choice."; press_any_key_to_continue();
+            }
+        } while(choice != 12);
+    }
+    
+    void user_menu() {
+        int choice;
+        display_art("art.txt");
+        std::cout << "\n\t |\t\t\t\t\t\t\t  1. NEW CUSTOMER";
+        std::cout << "\n\t |\t\t\t\t\t\t\t  2. EXISTING CUSTOMER";
+        std::cout << "\n\t |\t\t\t\t\t\t\t  3. PRICE CHECK";
+        std::cout << "\n\t |\t\t\t\t\t\t\t  4. SEARCH CARS";
+        std::cout << "\n\t |\t\t\t\t\t\t\t  5. BULK BOOKING";
+        std::cout << "\n\t |\t\t\t\t\t\t\t  6. MAIN MENU" << std::endl;
+        std::cout << "\n\n\t |\t\t\t\t\t\t\tINPUT : ";
+        choice = get_numeric_input();
+        clear_screen();
+        
+        switch(choice) {
+            case 1: new_customer_rental(); break;
+            case 2: existing_customer_rental(); break;
+            case 3: price_check(); break;
+            case 4: search_cars_screen(); break;
+            case 5: bulk_booking_screen(); break;
+            case 6: break;
+            default: std::cout << "\n\t | \t\tInvalid choice."; press_any_key_to_continue();
+        }
+    }
+
+    // --- Admin Functions ---
+    void add_new_user() {
+        draw_border();
+        gotoxy(40, 20);
+        UserPassword new_user;
+        new_user.id = users.empty() ? 1 : users.back().id + 1;
+        
+        std::cout << "\n\n\n\n\t | \t\t\tNew Admin ID (Default): " << new_user.id;
+        std::cout << "\n\t | \t\t\tEnter New Password: ";
+        new_user.password = get_password_input();
+        users.push_back(new_user);
+
+        std::ofstream ofs("UserPass.txt", std::ios::app);
+        ofs << "\n" << new_user.id << " " << new_user.password;
+        ofs.close();
+        
+        std::cout << "\n\t | \t\t\tNew admin added successfully!";
+        press_any_key_to_continue();
+    }
+    
+    void show_all_car_data() {
+        display_car_list();
+    }
+
+    void add_new_car() {
+        display_art("art.txt");
+        Car new_car;
+        std::cout << "\n\t | \t\tPlease enter the car data below:" << std::endl;
+        std::cout << "\n\t | \t\tPlate Number: "; std::getline(std::cin, new_car.plate_num);
+        std::cout << "\t | \t\tBrand: "; std::getline(std::cin, new_car.brand);
+        std::cout << "\t | \t\tModel: "; std::getline(std::cin, new_car.model);
+        std::cout << "\t | \t\tCapacity: "; std::cin >> new_car.capacity; std::cin.ignore();
+        std::cout << "\t | \t\tColour: "; std::getline(std::cin, new_car.colour);
+        std::cout << "\t | \t\tRate Per Hour: "; std::cin >> new_car.rate_per_hour; std::cin.ignore();
+        std::cout << "\t | \t\tRate Per 12 Hours: "; std::cin >> new_car.rate_per_half; std::cin.ignore();
+        std::cout << "\t | \t\tRate Per 24 Hours: "; std::cin >> new_car.rate_per_day; std::cin.ignore();
+        std::cout << "\t | \t\tTransmission (A/M): "; std::getline(std::cin, new_car.transmission);
+        std::string branch = MAIN_BRANCH;
+        std::vector<std::string> names = branches();
+        if (names.size() > 1) {
+            std::cout << "\t | \t\tBranch (" << join_names(names) << "): "; std::getline(std::cin, branch);
+            if (branch.empty()) branch = MAIN_BRANCH;
+        }
+
+        OpStatus status = add_car(new_car, branch);
+        if (status != OpStatus::OK) {
+            std::cout << (status == OpStatus::DUPLICATE ? "\n\t | \t\tA car with this plate number already exists."
+                                                         : "\n\t | \t\tInvalid car data.");
+            press_any_key_to_continue();
+            return;
+        }
+        
+        std::cout << "\n\t | \t\tCar added successfully!";
+        press_any_key_to_continue();
+    }
+
+    void delete_car() {
+        display_car_list();
+        std::string plate_to_delete;
+        std::cout << "\n\n\t | \t\tEnter the plate number of the car to delete: ";
+        std::getline(std::cin, plate_to_delete);
+        
+        OpStatus status = remove_car(plate_to_delete);
+        if (status == OpStatus::OK) {
+            std::cout << "\n\t | \t\tCar deleted successfully!";
+        } else if (status == OpStatus::NOT_AVAILABLE) {
+            std::cout << "\n\t | \t\tThe car is rented. Return it first.";
+        } else if (status == OpStatus::BOOKED) {
+            std::string answer;
+            std::cout << "\n\t | \t\tThe car has upcoming bookings. Delete it and cancel them? (y/n): ";
+            std::getline(std::cin, answer);
+            if (answer == "y" || answer == "Y") {
+                status = remove_car(plate_to_delete, true);
+                std::cout << (status == OpStatus::OK ? "\n\t | \t\tCar deleted and its bookings cancelled."
+                                                     : "\n\t | \t\tThe car could not be deleted.");
+            } else {
+                std::cout << "\n\t | \t\tThe car was not deleted.";
+            }
+        } else {
+            std::cout << "\n\t | \t\tCar not found.";
+        }
+        press_any_key_to_continue();
+    }
+    
+    // Transfers a car to another branch, or to a new one
+    void move_car_screen() {
+        display_car_list();
+        std::string plate, branch;
+        std::cout << "\n\n\t | \t\tEnter the plate number of the car to move: ";
+        std::getline(std::cin, plate);
+        std::cout << "\t | \t\tBranches: " << join_names(branches());
+        std::cout << "\n\t | \t\tMove to branch: ";
+        std::getline(std::cin, branch);
+
+        OpStatus status = move_car(plate, branch);
+        if (status == OpStatus::OK) {
+            std::cout << "\n\t | \t\tCar moved to " << branch << ".";
+        } else if (status == OpStatus::NOT_FOUND) {
+            std::cout << "\n\t | \t\tCar not found.";
+        } else {
+            std::cout << "\n\t | \t\tBranch names use letters, digits, '-' and '_' only.";
+        }
+        press_any_key_to_continue();
+    }
+
+    static std::string join_names(const std::vector<std::string>& names) {
+        std::string joined;
+        for (const std::string& name : names) joined += (joined.empty() ? "" : ", ") + name;
+        return joined;
+    }
+
+    void return_car_screen() {
+        display_art("art.txt");
+        std::string plate;
+        std::cout << "\n\t | \t\tEnter the plate number of the car being returned: ";
+        std::getline(std::cin, plate);
+
+        long long late_fee = 0;
+        OpStatus status = return_car(plate, late_fee);
+        if (status == OpStatus::OK) {
+            std::cout << "\n\t | \t\tCar " << plate << " is back in service.";
+            if (late_fee > 0) std::cout << "\n\t | \t\tLate return fee: RM " << format_money(late_fee);
+        } else if (status == OpStatus::NOT_FOUND) {
+            std::cout << "\n\t | \t\tCar not found.";
+        } else {
+            std::cout << "\n\t | \t\tThat car is not rented out.";
+        }
+        press_any_key_to_continue();
+    }
+
+    // Rented cars a page at a time, overdue ones first. Customer names are
+    // only looked up for the rows on screen.
+    void rented_cars_screen() {
+        static const size_t PAGE_ROWS = 20;
+        size_t first = 0, total = 0;
+        std::string notice;
+        for (;;) {
+            std::vector<RentedCar> rows = rented_cars(first, PAGE_ROWS, &total);
+            display_art("art.txt");
+            std::cout << "\n\t | \t\tRENTED CARS" << std::endl;
+            std::cout << "\t  |  Plate Number\tBrand\t Model\t\tCustomer\t\t     Since\t  Due\t       Status" << std::endl;
+            std::cout << "\t  |  ======================================================================================================================================" << std::endl;
+            for (const RentedCar& row : rows) {
+                char line[256];
+                snprintf(line, sizeof(line), "\t  |  %-15s\t%-8s\t %-15s %-6d %-16s %-12s %-12s %s\n", row.plate.c_str(),
+                         row.brand.c_str(), row.model.c_str(), row.customer_id, row.customer_name.substr(0, 16).c_str(),
+                         format_date_time(row.start, "%d/%m %H:%M").c_str(), format_date_time(row.due, "%d/%m %H:%M").c_str(),
+                         row.overdue ? "OVERDUE" : "RENTED");
+                std::cout << line;
+            }
+            if (rows.empty()) std::cout << "\t  |  No cars are rented out." << std::endl;
+            else std::cout << "\n\t | \t\tRows " << first + 1 << "-" << first + rows.size() << " of " << total;
+            std::cout << "   " << notice << "\n\t | \t\t[N]ext  [P]rev  [Q]uit";
+            notice.clear();
+
+            int key = std::tolower(read_key());
+            if (key == EOF || key == 'q' || key == 13 || key == '\n' || key == 27) break;
+            if (key == 'n' || key == ' ') {
+                if (first + PAGE_ROWS < total) first += PAGE_ROWS;
+                else notice = "(last page)";
+            } else if (key == 'p') {
+                if (first > 0) first -= std::min(first, PAGE_ROWS);
+                else notice = "(first page)";
+            }
+        }
+    }
+
+    void maintenance_screen() {
+        display_art("art.txt");
+        std::string plate;
+        std::cout << "\n\t | \t\tEnter the plate number of the car: ";
+        std::getline(std::cin, plate);
+        CarStatus current;
+        if (car_status(plate, current) != OpStatus::OK) {
+            std::cout << "\n\t | \t\tCar not found.";
+            press_any_key_to_continue();
+            return;
+        }
+        std::cout << "\t | \t\tStatus: " << car_status_name(current);
+        std::cout << "\n\t | \t\t1. Into maintenance  2. Back in service: ";
+        int choice = get_numeric_input();
+        if (choice != 1 && choice != 2) {
+            std::cout << "\n\t | \t\tInvalid choice.";
+        } else if (set_maintenance(plate, choice == 1) == OpStatus::OK) {
+            std::cout << "\n\t | \t\tCar " << plate << (choice == 1 ? " is in maintenance." : " is back in service.");
+        } else {
+            std::cout << "\n\t | \t\tThe car is rented out; return it first.";
+        }
+        press_any_key_to_continue();
+    }
+
+    void reset_available_cars() {
+        reset_availability();
+        display_loading_bar("UPDATING DATABASE...");
+        std::cout << "\n\t | \t\tAvailable car list has been reset to full stock.";
+        press_any_key_to_continue();
+    }
+    
+    // --- User Functions ---
+    void new_customer_rental() {
+        display_art("art.txt");
+        Customer new_cust;
+        int next_id = next_customer_id();
+
+        std::cout << "\n\t | \t\tPlease enter your details:" << std::endl;
+        std::cout << "\n\t | \t\tYour Customer ID will be: " << next_id << std::endl;
+        std::cout << "\t | \t\tName: "; std::getline(std::cin, new_cust.name);
+        std::cout << "\t | \t\tPhone Number: "; std::getline(std::cin, new_cust.phone);
+        std::cout << "\t | \t\tIC: "; std::getline(std::cin, new_cust.ic);
+        std::cout << "\t | \t\tAddress: "; std::getline(std::cin, new_cust.address);
+        
+        new_cust.id = register_customer(new_cust);
+        
+        std::cout << "\n\t | \t\tCustomer added successfully!";
+        press_any_key_to_continue();
+        
+        // Proceed to rental process
+        rent_a_car(new_cust);
+    }
+    
+    void existing_customer_rental() {
+        display_art("art.txt");
+        std::cout << "\n\t | \t\tPlease enter your Customer ID (0 to search): ";
+        int user_id = get_numeric_input();
+        if (user_id == 0) {
+            search_customer_screen();
+            std::cout << "\n\t | \t\tCustomer ID: ";
+            user_id = get_numeric_input();
+        }
+        
+        Customer cust;
+        if (find_customer(user_id, cust)) {
+            std::cout << "\n\t | \t\tWelcome back, " << cust.name << "!";
+            press_any_key_to_continue();
+            rent_a_car(cust);
+        } else {
+            std::cout << "\n\t | \t\tCustomer ID not found.";
+            press_any_key_to_continue();
+        }
+    }
+
+    // Search as you type: the list of matches is redrawn after every key press
+    // until Enter or Esc
+    void search_customer_screen() {
+        static const size_t MAX_SHOWN = 10;
+        static const char* field_names[] = {"NAME", "PHONE", "IC"};
+        std::cout << "\n\t | \t\tSearch by 1. NAME  2. PHONE  3. IC : ";
+        int choice = get_numeric_input();
+        CustomerField field = choice == 2 ? CustomerField::PHONE : choice == 3 ? CustomerField::IC : CustomerField::NAME;
+
+        std::string prefix;
+        for (;;) {
+            display_art("art.txt");
+            std::cout << "\n\t | \t\tSEARCH " << field_names[static_cast<int>(field)] << ": " << prefix << "_"
+                      << "\n\t | \t\t(type to narrow the list, Enter to pick an ID, Esc to stop)\n" << std::endl;
+            std::vector<Customer> matches = prefix.empty() ? std::vector<Customer>()
+                                                           : search_customers(field, prefix, MAX_SHOWN);
+            char line[256];
+            for (const Customer& cust : matches) {
+                snprintf(line, sizeof(line), "\t  |  %-8d %-25s %-15s %s\n", cust.id, cust.name.c_str(),
+                         cust.phone.c_str(), cust.ic.c_str());
+                std::cout << line;
+            }
+            if (!prefix.empty() && matches.empty()) std::cout << "\t  |  No matching customers." << std::endl;
+            std::cout.flush();
+
+            int ch = read_key();
+            if (ch == 13 || ch == '\n' || ch == 27 || ch == EOF) break;
+            if (ch == '\b' || ch == 127) {
+                if (!prefix.empty()) prefix.pop_back();
+            } else if (ch >= 32 && ch < 127) {
+                prefix += static_cast<char>(ch);
+            }
+        }
+    }
+
+    void rent_a_car(const Customer& cust) {
+        clear_screen();
+        display_art("art.txt");
+        std::cout << "\n\t | \t\tStart of rental, in hours from now (0 = now): ";
+        int start_offset = get_numeric_input();
+        std::cout << "\t | \t\tEnter hours of rent: ";
+        int hours = get_numeric_input();
+        if (start_offset < 0 || hours <= 0) {
+            std::cout << "\n\t | \t\tHours must be positive and the start cannot be in the past.";
+            press_any_key_to_continue();
+            return;
+        }
+        time_t start = time(0) + static_cast<time_t>(start_offset) * 3600;
+
+        display_free_cars(start, start + static_cast<time_t>(hours) * 3600);
+        
+        std::string plate_to_rent;
+        std::cout << "\n\n\t | \t\tEnter the plate number of the car you want to rent: ";
+        std::getline(std::cin, plate_to_rent);
+
+        long long total_cost = 0;
+        if (rent_car(cust, plate_to_rent, start, hours, total_cost) == OpStatus::OK) {
+            std::cout << "\n\t | \t\tTotal rental price for " << hours << " hours is: RM " << format_money(total_cost);
+        } else {
+            std::cout << "\n\t | \t\tInvalid plate number or car is not available.";
+        }
+
+        press_any_key_to_continue();
+    }
+
+
+    // Shows every available car priced for the requested hours, cheapest first
+    void price_check() {
+        display_art("art.txt");
+        std::cout << "\n\t | \t\tEnter hours of rent: ";
+        int hours = get_numeric_input();
+        std::cout << "\t | \t\tMaximum budget in RM (0 for no limit): ";
+        int budget = get_numeric_input();
+        if (hours <= 0) {
+            std::cout << "\n\t | \t\tHours of rent must be a positive number.";
+            press_any_key_to_continue();
+            return;
+        }
+
+        bool show_branch = branches().size() > 1;
+        std::vector<QuotedCar> quotes = quote_all(time(0), hours, 0, budget > 0 ? budget * 100LL : -1);
+        std::cout << "\n\t  |  Plate Number\tBrand\t Model\t\tCapacity   Transmission   " << (show_branch ? "Branch       " : "")
+                  << "Total (RM) for " << hours << " hours" << std::endl;
+        std::cout << "\t  |  ======================================================================================================================================" << std::endl;
+        for (const QuotedCar& quote : quotes) {
+            const Car& car = quote.car;
+            char line[256];
+            snprintf(line, sizeof(line), "\t  |  %-15s\t%-8s\t %-15s %-10.1f %-14s %s%s\n", car.plate_num.c_str(),
+                     car.brand.c_str(), car.model.c_str(), car.capacity, car.transmission.c_str(),
+                     show_branch ? (quote.branch + std::string(13 - std::min<size_t>(quote.branch.size(), 12), ' ')).c_str() : "",
+                     format_money(quote.cents).c_str());
+            std::cout << line;
+        }
+        if (quotes.empty()) std::cout << "\t  |  No available cars match." << std::endl;
+        press_any_key_to_continue();
+    }
+
+
+    // Available cars filtered by field values, capacity and a price range,
+    // cheapest first
+    void search_cars_screen() {
+        static const size_t MAX_ROWS = 20;
+        display_art("art.txt");
+        CarQuery query;
+        std::cout << "\n\t | \t\tLeave a field blank to accept any value.";
+        std::cout << "\n\t | \t\tBrand: "; std::getline(std::cin, query.brand);
+        std::cout << "\t | \t\tModel: "; std::getline(std::cin, query.model);
+        std::cout << "\t | \t\tColour: "; std::getline(std::cin, query.colour);
+        std::cout << "\t | \t\tTransmission: "; std::getline(std::cin, query.transmission);
+        bool show_branch = branches().size() > 1;
+        if (show_branch) {
+            std::cout << "\t | \t\tBranch: "; std::getline(std::cin, query.branch);
+        }
+        std::cout << "\t | \t\tMinimum capacity (0 for any): ";
+        query.min_capacity = static_cast<float>(get_numeric_input());
+        std::cout << "\t | \t\tPrice by 1. hour  2. 12 hours  3. 24 hours: ";
+        int rate = get_numeric_input();
+        query.rate = rate == 1 ? RateField::HOUR : rate == 2 ? RateField::HALF : RateField::DAY;
+        std::cout << "\t | \t\tMinimum price in RM: ";
+        query.min_cents = std::max(0, get_numeric_input()) * 100LL;
+        std::cout << "\t | \t\tMaximum price in RM (0 for no limit): ";
+        int max_price = get_numeric_input();
+        query.max_cents = max_price > 0 ? max_price * 100LL : -1;
+        query.start = time(0);
+        query.end = query.start + 1;
+        query.limit = MAX_ROWS;
+
+        std::vector<QuotedCar> found = search_cars(query);
+        std::cout << "\n";
+        print_car_header(show_branch);
+        for (const QuotedCar& quote : found) {
+            const Car& car = quote.car;
+            print_car_row(CarView{car.plate_num, car.brand, car.model, car.capacity, car.colour, car.rate_per_hour,
+                                  car.rate_per_half, car.rate_per_day, car.transmission, quote.branch},
+                          show_branch);
+        }
+        if (found.empty()) std::cout << "\t  |  No available cars match." << std::endl;
+        else if (found.size() == MAX_ROWS) std::cout << "\t  |  Showing the " << MAX_ROWS << " cheapest matches." << std::endl;
+        press_any_key_to_continue();
+    }
+
+    // A corporate booking of several groups of cars, booked together or not
+    // at all. Groups are typed one per line as in the batch allocate command.
+    void bulk_booking_screen() {
+        display_art("art.txt");
+        std::cout << "\n\t | \t\tCustomer ID: ";
+        Customer cust;
+        if (!find_customer(get_numeric_input(), cust)) {
+            std::cout << "\n\t | \t\tCustomer ID not found.";
+            press_any_key_to_continue();
+            return;
+        }
+        std::cout << "\t | \t\tOptimize for 1. LOWEST COST  2. BEST FIT: ";
+        AllocationGoal goal = get_numeric_input() == 2 ? AllocationGoal::BEST_FIT : AllocationGoal::LOWEST_COST;
+        std::cout << "\n\t | \t\tOne group of cars per line, e.g.  count=3 capacity=7 transmission=A budget=300 hours=24";
+        std::cout << "\n\t | \t\tKeys: count capacity transmission brand model colour branch budget (RM per car)";
+        std::cout << "\n\t | \t\t      hours start (hours from now). A blank line books the list.\n";
+
+        std::vector<AllocationRequest> requests;
+        std::string line;
+        for (;;) {
+            std::cout << "\t | \t\tGroup " << requests.size() + 1 << ": ";
+            if (!std::getline(std::cin, line) || line.empty()) break;
+            AllocationRequest request;
+            if (parse_allocation_request(line, time(0), request)) requests.push_back(request);
+            else std::cout << "\t | \t\tNot understood, please type the group again.\n";
+        }
+        if (requests.empty()) return;
+
+        AllocationPlan plan;
+        if (allocate_batch(cust, requests, goal, plan) != OpStatus::OK) {
+            std::cout << "\n\t | \t\tGroup " << plan.unfilled + 1 << " cannot be filled. Nothing was booked.";
+            press_any_key_to_continue();
+            return;
+        }
+        std::cout << "\n\t  |  Group  Plate Number             Brand      Model           Seats   From          Price (RM)" << std::endl;
+        std::cout << "\t  |  ==============================================================================================" << std::endl;
+        for (const Allocation& car : plan.cars) {
+            Car details{};
+            find_car(car.plate, details); // Left blank if the car was deleted since
+            char row[256];
+            snprintf(row, sizeof(row), "\t  |  %-6zu %-24s %-10s %-15s %-7g %-13s %s\n", car.request + 1,
+                     car.plate.c_str(), details.brand.c_str(), details.model.c_str(), details.capacity,
+                     format_date_time(requests[car.request].cars.start, "%d/%m %H:%M").c_str(),
+                     format_money(car.cents).c_str());
+            std::cout << row;
+        }
+        std::cout << "\n\t | \t\t" << plan.cars.size() << " cars booked for " << cust.name << ". Total: RM "
+                  << format_money(plan.total_cents);
+        press_any_key_to_continue();
+    }
+
+    // Call counts and latencies of the timed operations since startup
+    void show_statistics() {
+        display_art("art.txt");
+        std::vector<Histogram> totals = Metrics::snapshot();
+        std::cout << "\n\t  |  Operation\t\t    Count\t  Mean (us)    p50 (us)     p99 (us)     Max (us)" << std::endl;
+        std::cout << "\t  |  ======================================================================================================" << std::endl;
+        char line[256];
+        for (size_t m = 0; m < METRIC_COUNT; ++m) {
+            const Histogram& h = totals[m];
+            if (h.count == 0) continue;
+            snprintf(line, sizeof(line), "\t  |  %-22s %10llu   %10.1f   %10.1f   %10.1f   %10.1f\n", METRIC_NAMES[m],
+                     static_cast<unsigned long long>(h.count), h.mean_ns() / 1000.0, h.percentile(0.50) / 1000.0,
+                     h.percentile(0.99) / 1000.0, h.max_ns / 1000.0);
+            std::cout << line;
+        }
+        press_any_key_to_continue();
+    }
+
+    // Revenue and utilization from Log.txt for an optional range of days
+    void sales_report() {
+        display_art("art.txt");
+        std::string from_text, to_text;
+        std::cout << "\n\t | \t\tFrom date (DD/MM/YYYY, blank for all): "; std::getline(std::cin, from_text);
+        std::cout << "\t | \t\tTo date (DD/MM/YYYY, blank for all): "; std::getline(std::cin, to_text);
+        int from_day = 0, to_day = 0;
+        if ((!from_text.empty() && !parse_day(from_text, from_day)) || (!to_text.empty() && !parse_day(to_text, to_day))) {
+            std::cout << "\n\t | \t\tDates must be written as DD/MM/YYYY.";
+            press_any_key_to_continue();
+            return;
+        }
+
+        transaction_log.flush();
+        analytics.refresh();
+        std::cout << "\n";
+        print_sales_report(std::cout, analytics.report(from_day, to_day), 10, "\t |  ");
+        press_any_key_to_continue();
+    }
+
+
+    // --- Other Functions ---
+    void show_terms_and_conditions() {
+        display_art("art.txt");
+        std::cout << "\n\t |\t\t\t1. MINIMUM RENT TIME IS 3 HOURS";
+        std::cout << "\n\t |\t\t\t2. RENT AT YOUR OWN RISK";
+        std::cout << "\n\t |\t\t\t3. IN CASE OF AN ACCIDENT, ALL COSTS ARE BORNE BY THE DRIVER";
+        std::cout << "\n\t |\t\t\t4. PLEASE PREPARE THE FOLLOWING ITEMS:";
+        std::cout << "\n\t |\t\t\t     - COPY OF IC, LICENSE";
+        std::cout << "\n\t |\t\t\t     - DEPOSIT (BASED ON CAR TYPE)";
+        std::cout << "\n\t |\t\t\t5. ADDITIONAL CHARGES WILL APPLY FOR LATE RETURNS";
+        std::cout << "\n\t |\t\t\t6. DRIVE SAFELY!";
+        press_any_key_to_continue();
+    }
+    
+    // Lists the data file lines that were skipped while loading, or outside
+    // edits that were refused
+    void show_file_warnings(const std::vector<LoadError>& warnings, const std::string& heading) {
+        static const size_t MAX_SHOWN = 20;
+        display_art("art.txt");
+        std::cout << "\n\t | \t\tWARNING: " << warnings.size() << " " << heading << ":" << std::endl;
+        for (size_t i = 0; i < warnings.size() && i < MAX_SHOWN; ++i) {
+            const LoadError& error = warnings[i];
+            std::cout << "\n\t | \t\t" << error.file;
+            if (error.line > 0) std::cout << ":" << error.line;
+            std::cout << ": " << error.message;
+        }
+        if (warnings.size() > MAX_SHOWN) {
+            std::cout << "\n\t | \t\t... and " << warnings.size() - MAX_SHOWN << " more";
+        }
+        press_any_key_to_continue();
+    }
+
+    void run() {
+        display_art("welcome.txt");
+        pause_screen(1000);
+        display_loading_bar("BOOTING UP...");
+        if (!load_all_data()) {
+            show_file_warnings(load_errors, "problem(s) stopped the data from loading");
+            return;
+        }
+        start_file_sync();
+        if (!load_errors.empty()) show_file_warnings(load_errors, "problem(s) were found while loading");
+        main_menu();
+    }
+};
+
+// --- Batch Mode ---
+
+// Runs the operations in `path` against the rental system without the console
+// UI. One operation per line; blank lines and lines starting with # are ignored:
+//   register <name>;<phone>;<ic>;<address>
+//   rent <customer id> <plate> <hours> [start, in hours from now]
+//   allocate <customer id> [cost|fit] <request>; <request>...   (see parse_allocation_request)
+//   add <plate> <brand> <model> <capacity> <colour> <rate/hr> <rate/12hr> <rate/24hr> <transmission> [branch]
+//   return <plate>
+//   maintenance <plate> <on|off>
+//   rented
+//   delete <plate>
+//   move <plate> <branch>
+//   reset
+//   quote <hours> [limit]
+//   free <start, in hours from now> <hours>
+//   find <name|phone|ic> <prefix> [limit]
+// Prints one result line per operation and a throughput summary at the end.
+int run_batch(RentalSystem& app, const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open batch file " << path << std::endl;
+        return 1;
+    }
+
+    size_t line_no = 0, ops = 0, failed = 0;
+    std::string line;
+    auto start = std::chrono::steady_clock::now();
+    while (std::getline(file, line)) {
+        line_no++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream in(line);
+        std::string command;
+        if (!(in >> command) || command[0] == '#') continue;
+
+        OpStatus status = OpStatus::INVALID;
+        std::ostringstream detail;
+        if (command == "register") {
+            Customer cust;
+            std::string fields;
+            std::getline(in >> std::ws, fields);
+            if (!parse_customer_line("0;" + fields, cust)) {
+                detail << " id=" << app.register_customer(cust);
+                status = OpStatus::OK;
+            }
+        } else if (command == "rent") {
+            int customer_id, hours, start_offset = 0;
+            long long total_cost = 0;
+            std::string plate;
+            if (in >> customer_id >> plate >> hours) {
+                in >> start_offset;
+                Customer cust;
+                time_t start = time(0) + static_cast<time_t>(start_offset) * 3600;
+                status = app.find_customer(customer_id, cust) ? app.rent_car(cust, plate, start, hours, total_cost)
+                                                              : OpStatus::NOT_FOUND;
+                if (status == OpStatus::OK) detail << " cost=RM " << format_money(total_cost);
+            }
+        } else if (command == "allocate") {
+            int customer_id;
+            std::string text;
+            AllocationGoal goal;
+            std::vector<AllocationRequest> requests;
+            if (in >> customer_id && std::getline(in, text) && parse_allocation_batch(text, time(0), goal, requests)) {
+                Customer cust;
+                AllocationPlan plan;
+                status = app.find_customer(customer_id, cust) ? app.allocate_batch(cust, requests, goal, plan)
+                                                              : OpStatus::NOT_FOUND;
+                if (status == OpStatus::OK) {
+                    detail << " cars=" << plan.cars.size() << " total=RM " << format_money(plan.total_cents);
+                    for (const Allocation& car : plan.cars) detail << " " << car.plate;
+                } else if (status == OpStatus::NOT_AVAILABLE) {
+                    detail << " unfilled=" << plan.unfilled + 1;
+                }
+            }
+        } else if (command == "add") {
+            Car car;
+            std::string branch = MAIN_BRANCH;
+            if (read_car_record(in, car)) {
+                in >> branch;
+                status = app.add_car(car, branch);
+            }
+        } else if (command == "return") {
+            std::string plate;
+            long long late_fee = 0;
+            if (in >> plate) status = app.return_car(plate, late_fee);
+            if (late_fee > 0) detail << " late_fee=RM " << format_money(late_fee);
+        } else if (command == "maintenance") {
+            std::string plate, mode;
+            if (in >> plate >> mode && (mode == "on" || mode == "off")) status = app.set_maintenance(plate, mode == "on");
+        } else if (command == "rented") {
+            size_t total = 0;
+            std::vector<RentedCar> rows = app.rented_cars(0, 0, &total);
+            detail << " cars=" << total << " overdue="
+                   << std::count_if(rows.begin(), rows.end(), [](const RentedCar& row) { return row.overdue; });
+            status = OpStatus::OK;
+        } else if (command == "delete") {
+            std::string plate, option;
+            if (in >> plate && (!(in >> option) || option == "force")) status = app.remove_car(plate, option == "force");
+        } else if (command == "move") {
+            std::string plate, branch;
+            if (in >> plate >> branch) status = app.move_car(plate, branch);
+        } else if (command == "reset") {
+            app.reset_availability();
+            status = OpStatus::OK;
+        } else if (command == "quote") {
+            int hours;
+            size_t limit = 0;
+            if (in >> hours && hours > 0) {
+                in >> limit;
+                std::vector<QuotedCar> quotes = app.quote_all(time(0), hours, limit, -1);
+                detail << " cars=" << quotes.size();
+                if (!quotes.empty()) {
+                    detail << " cheapest=" << quotes[0].car.plate_num << " RM " << format_money(quotes[0].cents);
+                }
+                status = OpStatus::OK;
+            }
+        } else if (command == "free") {
+            int start_offset, hours;
+            if (in >> start_offset >> hours && hours > 0) {
+                time_t start = time(0) + static_cast<time_t>(start_offset) * 3600;
+                detail << " cars=" << app.free_cars(start, start + static_cast<time_t>(hours) * 3600).size();
+                status = OpStatus::OK;
+            }
+        } else if (command == "search") {
+            CarQuery query;
+            int start_offset = 0, hours = 1;
+            std::string option;
+            status = OpStatus::OK;
+            while (in >> option && status == OpStatus::OK) {
+                size_t eq = option.find('=');
+                std::string key = option.substr(0, eq), value = eq == std::string::npos ? "" : option.substr(eq + 1);
+                if (key == "rate" && (value == "hour" || value == "half" || value == "day"))
+                    query.rate = value == "hour" ? RateField::HOUR : value == "half" ? RateField::HALF : RateField::DAY;
+                else if (key == "min" && parse_cents(value, query.min_cents)) continue;
+                else if (key == "max" && parse_cents(value, query.max_cents)) continue;
+                else if (key == "limit" && parse_number(value, query.limit)) continue;
+                else if (!parse_car_option(key, value, query, start_offset, hours)) status = OpStatus::INVALID;
+            }
+            if (status == OpStatus::OK) {
+                query.start = time(0) + static_cast<time_t>(start_offset) * 3600;
+                query.end = query.start + static_cast<time_t>(hours) * 3600;
+                std::vector<QuotedCar> found = app.search_cars(query);
+                detail << " cars=" << found.size();
+                if (!found.empty()) {
+                    detail << " cheapest=" << found[0].car.plate_num << " RM " << format_money(found[0].cents);
+                }
+            }
+        } else if (command == "find") {
+            std::string field, prefix;
+            size_t limit = 10;
+            if (in >> field >> prefix && (field == "name" || field == "phone" || field == "ic")) {
+                in >> limit;
+                CustomerField key = field == "name" ? CustomerField::NAME : field == "phone" ? CustomerField::PHONE : CustomerField::IC;
+                std::vector<Customer> found = app.search_customers(key, prefix, limit);
+                detail << " customers=" << found.size();
+                for (const Customer& cust : found) detail << " " << cust.id;
+                status = OpStatus::OK;
+            }
+        }
+
+        ops++;
+        if (status != OpStatus::OK) failed++;
+        std::cout << line_no << ": " << command << " " << op_status_name(status) << detail.str() << "\n";
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n" << ops << " operations, " << ops - failed << " ok, " << failed << " failed in "
+              << seconds << " s (" << (seconds > 0 ? ops / seconds : 0) << " ops/s)" << std::endl;
+    return failed == 0 ? 0 : 2;
+}
+
+
+// --- Benchmarks ---
+
+// Generates synthetic data files of a given size and times the data layer
+// against them. Each result is printed as one JSON object per line so runs
+// can be diffed or fed to other tools.
+class Benchmark {
+public:
+    explicit Benchmark(size_t rows) : rows(rows), rng(12345) {}
+
+    // Writes car rental.txt, available.txt, Customer.txt, UserPass.txt and
+    // Log.txt with `rows` records each (UserPass.txt is capped at 1000)
+    void generate() {
+        static const char* brands[] = {"Toyota", "Honda", "Perodua", "Proton", "Nissan", "Mazda"};
+        static const char* models[] = {"Vios", "City", "Myvi", "Saga", "Almera", "CX5", "Axia", "Civic"};
+        static const char* colours[] = {"Red", "Blue", "White", "Black", "Silver", "Grey"};
+        static const char* names[] = {"Ahmad", "Siti", "Tan", "Kumar", "Lee", "Nur", "Wong", "Raj"};
+
+        std::ofstream cars("car rental.txt"), available("available.txt");
+        for (size_t i = 0; i < rows; ++i) {
+            Car car;
+            car.plate_num = plate(i);
+            car.brand = brands[rng() % 6];
+            car.model = models[rng() % 8];
+            car.capacity = static_cast<float>(2 + rng() % 7);
+            car.colour = colours[rng() % 6];
+            car.rate_per_hour = static_cast<float>(5 + rng() % 20);
+            car.rate_per_half = car.rate_per_hour * 8;
+            car.rate_per_day = car.rate_per_hour * 14;
+            car.transmission = rng() % 2 ? "A" : "M";
+            write_car_record(cars, car);
+            cars << "\n";
+            if (rng() % 4 != 0) {
+                write_car_record(available, car);
+                available << "\n";
+            }
+        }
+
+        std::ofstream customers("Customer.txt");
+        for (size_t i = 0; i < rows; ++i) {
+            Customer cust{static_cast<int>(1001 + i), names[rng() % 8], "01" + std::to_string(10000000 + rng() % 90000000),
+                          std::to_string(900000000000ULL + i), std::to_string(rng() % 999) + " Jalan Ampang"};
+            write_customer_record(customers, cust);
+            customers << "\n";
+        }
+
+        std::ofstream users("UserPass.txt");
+        for (size_t i = 0; i < std::min<size_t>(rows, 1000); ++i) users << i + 1 << " pw" << rng() % 100000 << "\n";
+
+        std::ofstream log("Log.txt");
+        for (size_t i = 0; i < rows; ++i) {
+            log << "\n==========================================================";
+            log << "\nDATE: " << 1 + rng() % 28 << "/" << 1 + rng() % 12 << "/2025 TIME: 12:00:00";
+            log << "\nCUSTOMER: " << names[rng() % 8] << " (ID: " << 1001 + rng() % rows << ")";
+            log << "\nCAR: " << plate(rng() % rows) << " (Toyota Vios)";
+            log << "\nHOURS: " << 1 + rng() % 72;
+            log << "\nPAYMENT: RM " << rng() % 1000;
+        }
+    }
+
+    void run(std::ostream& out) {
+        RentalSystem app;
+        measure(out, "load_all_data.text", 3, [&](size_t) {
+            std::filesystem::remove("fleet.snap");
+            std::filesystem::remove("fleet.journal");
+            std::filesystem::remove("Customer.idx");
+            app.load_all_data();
+        });
+        measure(out, "load_all_data.snapshot", 3, [&](size_t) { app.load_all_data(); });
+
+        size_t fleet_bytes = app.fleet_memory_usage();
+        out << "{\"rows\":" << rows << ",\"op\":\"fleet_memory\",\"bytes\":" << fleet_bytes
+            << ",\"bytes_per_car\":" << fleet_bytes / std::max<size_t>(1, app.car_count()) << "}" << std::endl;
+        std::vector<size_t> picks(100000);
+        for (auto& pick : picks) pick = rng() % rows;
+        volatile int sink = 0;
+
+        // The pricing rule alone, on rates copied out beforehand
+        std::vector<Car> priced(rows);
+        for (size_t i = 0; i < rows; ++i) app.find_car(plate(i), priced[i]);
+        measure(out, "calculate_rate", picks.size(), [&](size_t i) {
+            const Car& car = priced[picks[i]];
+            sink = sink + static_cast<int>(price_in_cents(RateSplit(1 + static_cast<int>(picks[i] % 72)),
+                                                          to_cents(car.rate_per_hour), to_cents(car.rate_per_half),
+                                                          to_cents(car.rate_per_day)));
+        });
+
+        size_t quotes = std::max<size_t>(10, std::min<size_t>(1000, 100000000 / rows));
+        measure(out, "quote_all", quotes, [&](size_t i) {
+            sink = sink + static_cast<int>(app.quote_all(time(0), 1 + static_cast<int>(picks[i] % 72), 10, -1).size());
+        });
+
+        // First call builds the indexes; the rest mix a field filter with a price range
+        static const char* query_brands[] = {"Toyota", "Honda", "Perodua", "Proton", "Nissan", "Mazda"};
+        measure(out, "search_cars", 1000, [&](size_t i) {
+            CarQuery query;
+            query.brand = query_brands[picks[i] % 6];
+            if (i % 2) query.transmission = "A";
+            query.min_capacity = static_cast<float>(2 + picks[i] % 5);
+            query.rate = RateField::HOUR;
+            query.max_cents = 1000 + static_cast<long long>(picks[i] % 1500);
+            query.start = time(0);
+            query.end = query.start + 3600;
+            query.limit = 10;
+            sink = sink + static_cast<int>(app.search_cars(query).size());
+        });
+
+        std::vector<std::string> plates;
+        for (size_t pick : picks) plates.push_back(plate(pick));
+        measure(out, "plate_lookup", plates.size(), [&](size_t i) {
+            Car car;
+            sink = sink + app.find_car(plates[i], car);
+        });
+
+        measure(out, "find_customer", picks.size(), [&](size_t i) {
+            Customer cust;
+            sink = sink + app.find_customer(static_cast<int>(1001 + picks[i]), cust);
+        });
+        out << "{\"rows\":" << rows << ",\"op\":\"customer_memory\",\"resident\":" << app.resident_customers()
+            << ",\"customers\":" << app.customer_count() << "}" << std::endl;
+
+        // Prefixes as typed at the front desk: a name, then growing phone prefixes.
+        // The first search reads its records through the cold cache.
+        static const char* prefixes[] = {"Ta", "011", "0123", "01234567"};
+        measure(out, "search_customers.first", 1, [&](size_t) {
+            sink = sink + static_cast<int>(app.search_customers(CustomerField::NAME, "Ta", 10).size());
+        });
+        measure(out, "search_customers", 10000, [&](size_t i) {
+            CustomerField field = i % 4 == 0 ? CustomerField::NAME : CustomerField::PHONE;
+            sink = sink + static_cast<int>(app.search_customers(field, prefixes[i % 4], 10).size());
+        });
+
+        measure(out, "save_data_to_file", 3, [&](size_t) { app.save_data_to_file("car rental.txt", false); });
+
+        // Cost of the instrumentation itself, a thousand timed spans at a time
+        measure(out, "scoped_timer.x1000", 1000, [&](size_t) {
+            for (int i = 0; i < 1000; ++i) ScopedTimer timer(Metric::RENT_PRICING);
+        });
+
+        // The first refresh parses the whole log; later ones only the last block
+        measure(out, "sales_report.full", 1, [&](size_t) {
+            SalesAnalytics analytics;
+            analytics.refresh();
+            sink = sink + static_cast<int>(analytics.report(0, 0).cars.size());
+        });
+        measure(out, "sales_report.cached", 3, [&](size_t) {
+            SalesAnalytics analytics;
+            analytics.refresh();
+            sink = sink + static_cast<int>(analytics.report(0, 0).cars.size());
+        });
+
+        // Hand a car over and take it straight back: two O(1) transitions and
+        // one journal record each
+        size_t cycles = std::min<size_t>(10000, rows);
+        Customer renter;
+        app.find_customer(1001, renter);
+        measure(out, "rent_and_return", cycles, [&](size_t i) {
+            long long cost = 0, late_fee = 0;
+            app.rent_car(renter, plate(i), time(0), 1, cost);
+            sink = sink + static_cast<int>(app.return_car(plate(i), late_fee));
+        });
+
+        // A corporate booking: ten people carriers and twenty automatics,
+        // planned over the whole fleet and booked as one journal group. Each
+        // iteration books a later day so the fleet never runs out.
+        std::vector<AllocationRequest> batch;
+        AllocationGoal goal;
+        parse_allocation_batch("count=10 capacity=7 budget=400 hours=24; count=20 transmission=A hours=24", 0, goal, batch);
+        measure(out, "allocate_batch", 20, [&](size_t i) {
+            std::vector<AllocationRequest> requests = batch;
+            for (AllocationRequest& request : requests) {
+                request.cars.start = time(0) + static_cast<time_t>(i + 1) * 86400;
+                request.cars.end = request.cars.start + 86400;
+            }
+            AllocationPlan plan;
+            sink = sink + static_cast<int>(app.allocate_batch(renter, requests, goal, plan));
+        });
+        app.shutdown();
+    }
+
+    static std::string plate(size_t i) { return "B" + std::to_string(1000000 + i); }
+
+private:
+    size_t rows;
+    std::mt19937_64 rng;
+
+    // Times fn(i) for i in [0, iterations) and prints latency percentiles
+    template <typename Fn>
+    void measure(std::ostream& out, const char* op, size_t iterations, Fn fn) {
+        std::vector<uint64_t> samples(iterations);
+        for (size_t i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            fn(i);
+            samples[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+        uint64_t total = 0;
+        for (uint64_t sample : samples) total += sample;
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&samples](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+        out << "{\"rows\":" << rows << ",\"op\":\"" << op << "\",\"iterations\":" << iterations
+            << ",\"p50_ns\":" << percentile(0.50) << ",\"p90_ns\":" << percentile(0.90)
+            << ",\"p99_ns\":" << percentile(0.99) << ",\"max_ns\":" << samples.back()
+            << ",\"ops_per_sec\":" << (total ? iterations * 1e9 / total : 0) << "}" << std::endl;
+    }
+};
+
+// Runs the benchmarks for each requested size (default 1k, 10k and 100k rows)
+// in a scratch directory under bench_data/
+int run_benchmarks(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    for (int i = 2; i < argc; ++i) {
+        size_t rows = 0;
+        if (!parse_number(argv[i], rows)) {
+            std::cerr << "Row counts must be whole numbers" << std::endl;
+            return 1;
+        }
+        sizes.push_back(rows);
+    }
+    if (sizes.empty()) sizes = {1000, 10000, 100000};
+
+    std::filesystem::path home = std::filesystem::current_path();
+    for (size_t rows : sizes) {
+        if (rows == 0) continue;
+        std::filesystem::path dir = home / "bench_data" / std::to_string(rows);
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        std::filesystem::current_path(dir);
+        Benchmark bench(rows);
+        bench.generate();
+        bench.run(std::cout);
+        std::filesystem::current_path(home);
+        std::filesystem::remove_all(dir);
+    }
+    return 0;
+}
+
+
+// --- Rental Server ---
+
+#ifdef _WIN32
+typedef SOCKET socket_handle;
+const socket_handle NO_SOCKET = INVALID_SOCKET;
+void close_socket(socket_handle sock) { closesocket(sock); }
+// True if the last failed socket call is worth retrying at once
+bool socket_error_is_transient() {
+    int error = WSAGetLastError();
+    return error == WSAEINTR || error == WSAEWOULDBLOCK || error == WSAECONNRESET;
+}
+#else
+typedef int socket_handle;
+const socket_handle NO_SOCKET = -1;
+void close_socket(socket_handle sock) { ::close(sock); }
+bool socket_error_is_transient() {
+    return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED;
+}
+#endif
+
+// Winsock has to be started before any socket call
+struct SocketLibrary {
+    SocketLibrary() {
+#ifdef _WIN32
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+    }
+    ~SocketLibrary() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+};
+
+// Unblocks any thread waiting on the socket
+void interrupt_socket(socket_handle sock) {
+#ifdef _WIN32
+    shutdown(sock, SD_BOTH);
+#else
+    shutdown(sock, SHUT_RDWR);
+#endif
+}
+
+socket_handle open_loopback_socket(uint16_t port, bool listening) {
+    socket_handle sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == NO_SOCKET) return NO_SOCKET;
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int one = 1;
+    bool ok;
+    if (listening) {
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+        ok = bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 && listen(sock, SOMAXCONN) == 0;
+    } else {
+        ok = connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+    }
+    if (!ok) {
+        close_socket(sock);
+        return NO_SOCKET;
+    }
+    return sock;
+}
+
+// Line based reads and writes over a connected socket
+class SocketStream {
+public:
+    explicit SocketStream(socket_handle sock) : sock(sock) {}
+
+    bool read_line(std::string& line) {
+        while (true) {
+            size_t end = buffer.find('\n', start);
+            if (end != std::string::npos) {
+                line.assign(buffer, start, end - start);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                start = end + 1;
+                return true;
+            }
+            buffer.erase(0, start);
+            start = 0;
+            char chunk[4096];
+            int received = recv(sock, chunk, sizeof(chunk), 0);
+            if (received <= 0) return false;
+            buffer.append(chunk, received);
+        }
+    }
+
+    bool write_line(const std::string& text) {
+        std::string line = text + "\n";
+        size_t sent = 0;
+        while (sent < line.size()) {
+#ifdef MSG_NOSIGNAL
+            int n = send(sock, line.data() + sent, static_cast<int>(line.size() - sent), MSG_NOSIGNAL);
+#else
+            int n = send(sock, line.data() + sent, static_cast<int>(line.size() - sent), 0);
+#endif
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+private:
+    socket_handle sock;
+    std::string buffer;
+    size_t start = 0;
+};
+
+// Serves the rental operations to many local clients at once over loopback TCP.
+// Accepted connections are handed to a pool of worker threads; every request
+// is one line and gets one line back:
+//   REGISTER <name>;<phone>;<ic>;<address>      -> OK <customer id>
+//   RENT <customer id> <plate> <hours> [start]  -> OK <price> | ERR <status>
+//   ALLOCATE <customer id> [cost|fit] <request>; ...
+//                                               -> OK <total> <plate>:<price> ... | ERR NOT_AVAILABLE <request>
+//   RETURN <plate>                              -> OK <late fee> | ERR <status>
+//   RENTED [limit]                              -> OK <plate>:<customer id>:<RENTED|OVERDUE> ...
+//   MOVE <plate> <branch>                       -> OK | ERR <status>
+//   QUOTE <hours> [limit]                       -> OK <plate>:<price> ...
+//   FREE <start> <hours>                        -> OK <count>
+//   PLATES [limit]                              -> OK <plate> ...
+//   SHUTDOWN                                    -> OK, then the server stops
+// Start offsets are in hours from now.
+class RentalServer {
+public:
+    RentalServer(RentalSystem& app, uint16_t port, size_t workers) : app(app), port(port), worker_count(workers) {}
+
+    int run() {
+        listener = open_loopback_socket(port, true);
+        if (listener == NO_SOCKET) {
+            std::cerr << "Cannot listen on 127.0.0.1:" << port << std::endl;
+            return 1;
+        }
+        std::cout << "Listening on 127.0.0.1:" << port << " with " << worker_count << " workers" << std::endl;
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < worker_count; ++i) workers.emplace_back(&RentalServer::work, this);
+        // Out of descriptors (EMFILE) and the like do not clear at once, so the
+        // loop backs off instead of spinning on them
+        std::chrono::milliseconds backoff(0);
+        while (!stopping) {
+            socket_handle client = accept(listener, nullptr, nullptr);
+            if (client == NO_SOCKET) {
+                if (!stopping && !socket_error_is_transient()) {
+                    backoff = std::min(std::max(backoff * 2, MIN_ACCEPT_BACKOFF), MAX_ACCEPT_BACKOFF);
+                    std::this_thread::sleep_for(backoff);
+                }
+                continue;
+            }
+            backoff = std::chrono::milliseconds(0);
+            int one = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            pending.push_back(client);
+            queue_ready.notify_one();
+        }
+        for (auto& worker : workers) worker.join();
+        close_socket(listener);
+        return 0;
+    }
+
+private:
+    static constexpr std::chrono::milliseconds MIN_ACCEPT_BACKOFF{10};
+    static constexpr std::chrono::milliseconds MAX_ACCEPT_BACKOFF{500};
+
+    RentalSystem& app;
+    uint16_t port;
+    size_t worker_count;
+    socket_handle listener = NO_SOCKET;
+    std::atomic<bool> stopping{false};
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::vector<socket_handle> pending;
+    std::vector<socket_handle> active;      // Guarded by queue_mutex
+
+    void work() {
+        while (true) {
+            socket_handle client;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_ready.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (stopping) return;
+                client = pending.back();
+                pending.pop_back();
+                active.push_back(client);
+            }
+            serve(client);
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                active.erase(std::find(active.begin(), active.end(), client));
+            }
+            close_socket(client);
+        }
+    }
+
+    void serve(socket_handle client) {
+        SocketStream stream(client);
+        std::string line;
+        while (!stopping && stream.read_line(line)) {
+            if (line == "SHUTDOWN") {
+                stream.write_line("OK");
+                stop();
+                return;
+            }
+            if (!stream.write_line(handle(line))) return;
+        }
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+        for (socket_handle sock : active) interrupt_socket(sock);
+        for (socket_handle sock : pending) close_socket(sock);
+        pending.clear();
+        queue_ready.notify_all();
+        interrupt_socket(listener);
+#ifdef _WIN32
+        closesocket(listener);  // shutdown() does not wake accept() on Windows
+#endif
+    }
+
+    std::string handle(const std::string& line) {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        std::ostringstream reply;
+        if (command == "REGISTER") {
+            Customer cust;
+            std::string fields;
+            std::getline(in >> std::ws, fields);
+            if (parse_customer_line("0;" + fields, cust)) return "ERR INVALID";
+            reply << "OK " << app.register_customer(cust);
+        } else if (command == "RENT") {
+            int customer_id, hours, start_offset = 0;
+            std::string plate;
+            if (!(in >> customer_id >> plate >> hours)) return "ERR INVALID";
+            in >> start_offset;
+            Customer cust;
+            if (!app.find_customer(customer_id, cust)) return "ERR NOT_FOUND";
+            long long total_cost = 0;
+            time_t start = time(0) + static_cast<time_t>(start_offset) * 3600;
+            OpStatus status = app.rent_car(cust, plate, start, hours, total_cost);
+            if (status != OpStatus::OK) return std::string("ERR ") + op_status_name(status);
+            reply << "OK " << format_money(total_cost);
+        } else if (command == "RETURN") {
+            std::string plate;
+            if (!(in >> plate)) return "ERR INVALID";
+            long long late_fee = 0;
+            OpStatus status = app.return_car(plate, late_fee);
+            if (status != OpStatus::OK) return std::string("ERR ") + op_status_name(status);
+            reply << "OK " << format_money(late_fee);
+        } else if (command == "ALLOCATE") {
+            int customer_id;
+            std::string text;
+            AllocationGoal goal;
+            std::vector<AllocationRequest> requests;
+            if (!(in >> customer_id) || !std::getline(in, text) || !parse_allocation_batch(text, time(0), goal, requests)) {
+                return "ERR INVALID";
+            }
+            Customer cust;
+            if (!app.find_customer(customer_id, cust)) return "ERR NOT_FOUND";
+            AllocationPlan plan;
+            OpStatus status = app.allocate_batch(cust, requests, goal, plan);
+            if (status == OpStatus::NOT_AVAILABLE) return "ERR NOT_AVAILABLE " + std::to_string(plan.unfilled + 1);
+            if (status != OpStatus::OK) return std::string("ERR ") + op_status_name(status);
+            reply << "OK " << format_money(plan.total_cents);
+            for (const Allocation& car : plan.cars) reply << " " << car.plate << ":" << format_money(car.cents);
+        } else if (command == "MOVE") {
+            std::string plate, branch;
+            if (!(in >> plate >> branch)) return "ERR INVALID";
+            OpStatus status = app.move_car(plate, branch);
+            return status == OpStatus::OK ? "OK" : std::string("ERR ") + op_status_name(status);
+        } else if (command == "QUOTE") {
+            int hours;
+            size_t limit = 10;
+            if (!(in >> hours) || hours <= 0) return "ERR INVALID";
+            in >> limit;
+            reply << "OK";
+            for (const auto& priced : app.quote_plates(time(0), hours, limit)) {
+                reply << " " << priced.first << ":" << format_money(priced.second);
+            }
+        } else if (command == "FREE") {
+            int start_offset, hours;
+            if (!(in >> start_offset >> hours) || hours <= 0) return "ERR INVALID";
+            time_t start = time(0) + static_cast<time_t>(start_offset) * 3600;
+            reply << "OK " << app.free_cars(start, start + static_cast<time_t>(hours) * 3600).size();
+        } else if (command == "RENTED") {
+            size_t limit = 0;
+            in >> limit;
+            reply << "OK";
+            for (const RentedCar& row : app.rented_cars(0, limit)) {
+                reply << " " << row.plate << ":" << row.customer_id << ":"
+                      << car_status_name(row.overdue ? CarStatus::OVERDUE : CarStatus::RENTED);
+            }
+        } else if (command == "PLATES") {
+            size_t limit = 0;
+            in >> limit;
+            time_t now = time(0);
+            reply << "OK";
+            for (const auto& plate : app.free_cars(now, now + 1, limit)) reply << " " << plate;
+        } else {
+            return "ERR UNKNOWN_COMMAND";
+        }
+        return reply.str();
+    }
+};
+
+// Hammers a running server with RENT requests from `clients` connections for
+// `seconds`, choosing random plates and overlapping windows so clients compete
+// for the same cars. Prints one JSON line with throughput and latency.
+int run_load_generator(uint16_t port, size_t clients, int seconds) {
+    SocketLibrary sockets;
+    socket_handle setup = open_loopback_socket(port, false);
+    if (setup == NO_SOCKET) {
+        std::cerr << "Cannot connect to 127.0.0.1:" << port << std::endl;
+        return 1;
+    }
+    SocketStream setup_stream(setup);
+    std::string reply;
+    setup_stream.write_line("REGISTER Load Generator;000;000;localhost");
+    setup_stream.read_line(reply);
+    std::string customer_id = reply.size() > 3 ? reply.substr(3) : "0";
+    setup_stream.write_line("PLATES 1000");
+    setup_stream.read_line(reply);
+    close_socket(setup);
+
+    std::istringstream plate_list(reply.size() > 3 ? reply.substr(3) : "");
+    std::vector<std::string> plates;
+    for (std::string plate; plate_list >> plate;) plates.push_back(plate);
+    if (plates.empty()) {
+        std::cerr << "The server has no free cars to rent" << std::endl;
+        return 1;
+    }
+
+    std::atomic<size_t> requests{0}, rentals{0}, conflicts{0};
+    std::vector<std::vector<uint64_t>> latencies(clients);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    auto client_loop = [&](size_t id) {
+        socket_handle sock = open_loopback_socket(port, false);
+        if (sock == NO_SOCKET) return;
+        SocketStream stream(sock);
+        std::mt19937 rng(static_cast<unsigned>(id * 7919 + 1));
+        std::string answer;
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::string request = "RENT " + customer_id + " " + plates[rng() % plates.size()] + " " +
+                                  std::to_string(1 + rng() % 4) + " " + std::to_string(rng() % 48);
+            auto start = std::chrono::steady_clock::now();
+            if (!stream.write_line(request) || !stream.read_line(answer)) break;
+            latencies[id].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now() - start).count());
+            requests++;
+            if (answer.compare(0, 2, "OK") == 0) rentals++;
+            else if (answer == "ERR NOT_AVAILABLE") conflicts++;
+        }
+        close_socket(sock);
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < clients; ++i) threads.emplace_back(client_loop, i);
+    for (auto& t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::vector<uint64_t> all;
+    for (const auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) { return all.empty() ? 0 : all[static_cast<size_t>(p * (all.size() - 1))]; };
+    std::cout << "{\"clients\":" << clients << ",\"seconds\":" << elapsed << ",\"requests\":" << requests
+              << ",\"rentals\":" << rentals << ",\"conflicts\":" << conflicts
+              << ",\"requests_per_sec\":" << requests / elapsed << ",\"rentals_per_sec\":" << rentals / elapsed
+              << ",\"p50_ns\":" << percentile(0.50) << ",\"p99_ns\":" << percentile(0.99) << "}" << std::endl;
+    return 0;
+}
+
+
+// Parses one --log-* option. Returns false for an unknown value.
+bool parse_log_option(const std::string& option, const std::string& value, LogConfig& config) {
+    if (option == "--log-format") {
+        if (value == "block") config.format = LogFormat::BLOCK;
+        else if (value == "csv") config.format = LogFormat::CSV;
+        else if (value == "both") config.format = LogFormat::BOTH;
+        else return false;
+    } else if (option == "--log-durability") {
+        if (value == "buffered") config.durability = LogDurability::BUFFERED;
+        else if (value == "flush") config.durability = LogDurability::FLUSH;
+        else if (value == "fsync") config.durability = LogDurability::FSYNC;
+        else return false;
+    } else if (option == "--log-flush-ms") {
+        int milliseconds = 0;
+        if (!parse_number(value, milliseconds) || milliseconds <= 0) return false;
+        config.flush_interval = std::chrono::milliseconds(milliseconds);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Parses one --stats-* option. Returns false for an unknown value.
+bool parse_stats_option(const std::string& option, const std::string& value, StatsConfig& config) {
+    if (option == "--stats-file") {
+        config.file = value;
+    } else if (option == "--stats-interval-ms") {
+        int milliseconds = 0;
+        if (!parse_number(value, milliseconds) || milliseconds <= 0) return false;
+        config.interval = std::chrono::milliseconds(milliseconds);
+    } else if (option == "--stats-trace") {
+        config.trace_file = value;
+    } else {
+        return false;
+    }
+    return !value.empty();
+}
+
+// Parses the optional [port] [count] [seconds] arguments of --serve and --loadgen.
+// Missing arguments keep their defaults. Returns false for anything that is not a
+// positive whole number, or a port outside 1..65535.
+bool parse_network_args(int argc, char* argv[], uint16_t& port, size_t& count, int& seconds) {
+    unsigned long long value = 0;
+    if (argc > 2) {
+        if (!parse_number(argv[2], value) || value == 0 || value > 65535) return false;
+        port = static_cast<uint16_t>(value);
+    }
+    if (argc > 3) {
+        if (!parse_number(argv[3], count) || count == 0) return false;
+    }
+    if (argc > 4) {
+        if (!parse_number(argv[4], seconds) || seconds <= 0) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Transaction log and stats options may appear anywhere; strip them before the mode
+    LogConfig log_config;
+    StatsConfig stats_config;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 8, "--stats-") == 0) {
+            if (i + 1 >= argc || !parse_stats_option(arg, argv[i + 1], stats_config)) {
+                std::cerr << "Invalid value for " << arg << std::endl;
+                return 1;
+            }
+            i++;
+        } else if (arg.compare(0, 6, "--log-") == 0) {
+            if (i + 1 >= argc || !parse_log_option(arg, argv[i + 1], log_config)) {
+                std::cerr << "Invalid value for " << arg << std::endl;
+                return 1;
+            }
+            i++;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    // Headless modes: text converters, batch processing and benchmarks
+    if (argc > 1) {
+        std::string option = argv[1];
+        if (option == "--bench") return run_benchmarks(argc, argv);
+        if (option == "--report") return run_report(argc, argv);
+        if (option == "--loadgen") {
+            uint16_t port = 5555;
+            size_t clients = 8;
+            int seconds = 10;
+            if (!parse_network_args(argc, argv, port, clients, seconds)) {
+                std::cerr << "Invalid port, client count or duration" << std::endl;
+                return 1;
+            }
+            return run_load_generator(port, clients, seconds);
+        }
+        RentalSystem app;
+        app.configure_log(log_config);
+        app.configure_stats(stats_config);
+        int status = 0;
+        if (option == "--batch" && argc > 2) {
+            if (app.load_all_data()) {
+                status = run_batch(app, argv[2]);
+                app.shutdown();
+            } else {
+                status = 1;
+            }
+        } else if (option == "--serve") {
+            uint16_t port = 5555;
+            size_t workers = std::max(2u, std::thread::hardware_concurrency() * 2);
+            int unused_seconds = 0;
+            if (argc > 4 || !parse_network_args(argc, argv, port, workers, unused_seconds)) {
+                std::cerr << "Invalid port or worker count" << std::endl;
+                return 1;
+            }
+            SocketLibrary sockets;
+            if (app.load_all_data()) {
+                app.start_file_sync(true);
+                RentalServer server(app, port, workers);
+                status = server.run();
+                app.shutdown();
+            } else {
+                status = 1;
+            }
+        } else if (option == "--import-text") {
+            if (!app.import_text()) status = 1;
+        } else if (option == "--export-text") {
+            if (app.load_all_data()) {
+                app.export_text();
+                app.shutdown();
+            } else {
+                status = 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--import-text | --export-text | --batch <file> | --bench [rows...] |\n"
+                      << "        --report [from] [to] [top] |\n"
+                      << "        --serve [port] [workers] | --loadgen [port] [clients] [seconds]]\n"
+                      << "       [--log-format block|csv|both] [--log-durability buffered|flush|fsync] [--log-flush-ms N]\n"
+                      << "       [--stats-file <file>] [--stats-interval-ms N] [--stats-trace <file>]" << std::endl;
+            return 1;
+        }
+        for (const auto& error : app.errors()) {
+            std::cerr << error.file << ":" << error.line << ": " << error.message << std::endl;
+        }
+        std::cout << app.car_count() << " cars, " << app.customer_count() << " customers" << std::endl;
+        return status;
+    }
+
+
+    // This Windows-specific function can be used to attempt to set fullscreen.
+    // May not work on all systems.
+    // keybd_event(VK_MENU, 0x38, 0, 0);
+    // keybd_event(VK_RETURN, 0x1c, 0, 0);
+    // keybd_event(VK_RETURN, 0x1c, KEYEVENTF_KEYUP, 0);
+    // keybd_event(VK_MENU, 0x38, KEYEVENTF_KEYUP, 0);
+
+    RentalSystem app;
+    app.configure_log(log_config);
+    app.configure_stats(stats_config);
+    TerminalRenderer::install();
+    app.run();
+    TerminalRenderer::uninstall();
+
+    return 0;
 }
\ No newline at end of file
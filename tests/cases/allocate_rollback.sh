@@ -0,0 +1,21 @@
+# A bulk booking is all or nothing: when one request cannot be filled no car
+# is booked, logged or journaled. A booking that succeeds is journaled as one
+# group, which survives a restart.
+new_store
+mkdir fleet.snap.tmp
+batch <<'EOF'
+allocate 1001 count=2 capacity=5 start=1 hours=24; count=2 capacity=7 start=1 hours=24
+search start=1 hours=24
+allocate 1001 count=2 capacity=5 start=1 hours=24; count=1 capacity=7 start=1 hours=24
+search start=1 hours=24
+allocate 1001 count=2 capacity=5 start=1 hours=24
+search start=1 hours=24
+EOF
+echo "--- fleet.journal"
+sed 's/ [0-9][0-9]* [0-9][0-9]* 1001$/ <start> <end> 1001/' fleet.journal
+echo "--- Log.txt: $(grep -c '^CAR:' Log.txt) rentals"
+rmdir fleet.snap.tmp
+echo "--- restart"
+batch <<'EOF'
+search start=1 hours=24
+EOF
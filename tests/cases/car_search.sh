@@ -0,0 +1,41 @@
+# search filters the fleet by its indexed fields and a price range on one of
+# the three rates, cheapest first, and follows rentals, maintenance, edits and
+# deletions.
+new_store
+batch <<'EOF2'
+add F5 Toyota Yaris 5 Blue 9 55 95 A
+add F6 Honda BR-V 7 White 14 75 130 A
+search
+search brand=Toyota
+search brand=Toyota model=Vios
+search brand=toyota
+search capacity=7
+search capacity=6 transmission=A
+search transmission=M
+search colour=White
+search rate=day min=100 max=120
+search rate=half max=60
+search min=13
+search min=120
+search brand=Honda limit=1
+search hours=24
+search hours=13 max=100
+rent 1001 F5 3
+search brand=Toyota
+search brand=Toyota start=5
+maintenance F6 on
+search capacity=7
+maintenance F6 off
+delete F4
+search capacity=7
+add F4 Perodua Alza 7 Silver 8 40 70 M
+search capacity=7
+search transmission=A capacity=7
+search branch=main
+search branch=nowhere
+search colour
+search min=abc
+search hours=0
+search rate=week
+search size=5
+EOF2
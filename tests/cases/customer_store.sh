@@ -0,0 +1,31 @@
+# Customers live in the append-only Customer.txt, indexed by Customer.idx.
+# Registered customers are written before their ID is handed out, rows that
+# other programs append are picked up without a rebuild, and any other edit
+# rebuilds the index.
+new_store
+echo "--- registered"
+batch <<'EOF2'
+register Mei Lin;0167;IC2;2 Jalan Raja
+register Ahmad Ali;0199;IC3;3 Jalan Ampang
+find name a
+find name MEI
+find phone 01 2
+find ic IC3
+find name zz
+find address x
+EOF2
+cat Customer.txt
+echo "--- appended by another program"
+printf '1004;Alan Wong;0111;IC4;4 Jalan Ipoh\nnot a customer\n1002;Someone Else;0;IC9;x\n' >> Customer.txt
+batch <<'EOF2'
+find name al
+register Siti Noor;0122;IC5;5 Jalan Tun
+rent 1004 F1 2
+EOF2
+echo "--- rewritten"
+sed -i 's/^1003;Ahmad Ali/1003;Zainal Bakar/' Customer.txt
+batch <<'EOF2'
+find name ahmad
+find name zai
+find ic IC
+EOF2
@@ -0,0 +1,31 @@
+# A car with upcoming bookings is only deleted with "force". The bookings it
+# drops are journaled as K records with the deletion.
+new_store
+batch <<'EOF2'
+rent 1001 F1 2 24
+rent 1001 F1 3 48
+rent 1001 F2 2
+delete F1
+delete F2
+delete F2 force
+delete F1 now
+delete F1 force
+delete F1 force
+free 24 2
+EOF2
+echo "--- restart"
+batch <<'EOF2'
+free 24 2
+add F1 Toyota Vios 5 White 10 60 100 A
+rent 1001 F1 2 24
+EOF2
+echo "--- a K record replayed"
+now=$(date +%s)
+echo "B F3 $((now + 86400)) $((now + 93600)) 1001" >> fleet.journal
+batch <<'EOF2'
+free 24 2
+EOF2
+echo "K F3 $((now + 86400)) $((now + 93600)) 1001" >> fleet.journal
+batch <<'EOF2'
+free 24 2
+EOF2
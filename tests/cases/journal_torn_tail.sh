@@ -0,0 +1,24 @@
+# A crash left a complete record, a complete group and a group whose second
+# record was cut off. Replay applies the first two, drops the torn group and
+# cuts it off the file, so records appended afterwards are not glued to it.
+new_store
+printf 'A J1 Kia Picanto 4 Blue 8 50 90 A\nG 2\nA J2 Kia Rio 5 Grey 9 55 95 A\nD F3\nG 2\nA J3 Kia Soul 5 Green 9 55 95 A\nA J4 Kia Sel' >> fleet.journal
+# Makes the snapshot unwritable, so shutdown leaves the journal in place
+mkdir fleet.snap.tmp
+batch <<'EOF'
+search model=Picanto
+search model=Rio
+search model=City
+search model=Soul
+search model=Seltos
+add K1 Proton Saga 5 White 7 45 85 A
+EOF
+echo "--- fleet.journal"
+cat fleet.journal
+rmdir fleet.snap.tmp
+echo "--- restart"
+batch <<'EOF'
+search model=Rio
+search model=Saga
+EOF
+echo "--- fleet.journal: $(wc -c < fleet.journal) bytes"
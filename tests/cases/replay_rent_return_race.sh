@@ -0,0 +1,31 @@
+# Clients race RENT and RETURN on the same two cars. The journal must hold
+# each car's O and I records in the order the changes were made, so a server
+# killed afterwards replays to exactly the state it had.
+new_store
+serve || return
+client() {
+    exec 4<> "/dev/tcp/127.0.0.1/$port"
+    for i in $(seq 1500); do
+        printf 'RENT 1001 F%d 2\nRETURN F%d\n' $(((i + $1) % 2 + 1)) $((i % 2 + 1))
+    done >&4
+    head -n 3000 <&4 > /dev/null
+}
+clients=
+for c in $(seq 12); do
+    client $c &
+    clients="$clients $!"
+done
+wait $clients
+live=$(printf 'RENTED\nFREE 0 1\nFREE 1 1\n' | request)
+awk '$1 == "O" || $1 == "I" { if (last[$2] == $1) bad++; last[$2] = $1 }
+     END { print "out of order O/I records: " bad + 0 }' fleet.journal
+kill -9 $server
+wait $server 2> /dev/null
+serve || return
+replayed=$(printf 'RENTED\nFREE 0 1\nFREE 1 1\n' | request)
+stop_server
+if [ "$live" = "$replayed" ]; then
+    echo "replayed state matches the live one"
+else
+    printf 'live:\n%s\nreplayed:\n%s\n' "$live" "$replayed"
+fi
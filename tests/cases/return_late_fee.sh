@@ -0,0 +1,31 @@
+# Returns through the rental state machine. F1 was handed over 2h50m ago for
+# one hour, so it is overdue and charged for the two extra hours it was out.
+# F2 is booked for later. F3's booking is under way but was never handed over,
+# so returning it only ends the booking. F4 is returned before it is due.
+new_store
+now=$(date +%s)
+cat >> fleet.journal <<EOF2
+O F1 $((now - 10200)) $((now - 6600)) 1001
+B F2 $((now + 7200)) $((now + 14400)) 1001
+B F3 $((now - 600)) $((now + 3000)) 1001
+EOF2
+batch <<'EOF2'
+rented
+rent 1001 F4 5
+return F1
+return F1
+return F2
+return F3
+return F4
+return NOPE
+rented
+free 0 1
+EOF2
+echo "--- Log.txt"
+grep -A 3 '^CUSTOMER' Log.txt
+echo "--- restart"
+batch <<'EOF2'
+rented
+free 0 1
+free 2 1
+EOF2
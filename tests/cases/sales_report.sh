@@ -0,0 +1,34 @@
+# --report totals the blocks in Log.txt and caches per-day totals in
+# Log.rollup. Later reports parse only what was appended; a log that was
+# rewritten or replaced by an older copy is parsed again from the start.
+mkdir report && cd report || exit 1
+block() {
+    printf '\n==========================================================\n'
+    printf 'DATE: %s TIME: 12:00:00\nCUSTOMER: %s (ID: %d)\n' "$1" "$2" "$3"
+    printf 'CAR: %s (%s)\nHOURS: %d\nPAYMENT: RM %s\n' "$4" "$5" "$6" "$7"
+}
+report() {
+    "$app" --report "$@" | sed 's/ in [0-9.e+-]* s$//'
+}
+{
+    block 01/03/2025 "Ali Tan" 1001 F1 "Toyota Vios" 5 50.00
+    block 01/03/2025 "Mei Lin" 1002 F3 "Honda City" 2 24.00
+    block 02/03/2025 "Ali Tan" 1001 F3 "Honda City" 10 120.00
+} > Log.txt
+echo "--- first report"
+report
+echo "--- appended"
+block 05/03/2025 "Mei Lin" 1002 F4 "Perodua Alza" 24 140.00 >> Log.txt
+report 02/03/2025 - 1
+echo "--- rewritten with the same length"
+sed -i 's/RM 50.00/RM 90.00/' Log.txt
+report
+echo "--- an older copy"
+head -c 300 Log.txt > older.txt
+block 03/03/2025 "Ali Tan" 1001 F2 "Toyota Vios" 1 10.00 >> older.txt
+touch -d '2000-01-01' older.txt
+mv older.txt Log.txt
+report - - 2
+echo "--- bad arguments"
+report 2025-03-01
+report - - many
@@ -0,0 +1,39 @@
+# Every request of the server protocol over loopback TCP, including the
+# errors, and a restart that shows the server's changes were saved
+new_store
+serve || return
+request <<'EOF2'
+REGISTER Siti Aminah;0177;IC2;2 Jalan Laut
+RENT 1002 F1 5
+RENT 1002 F1 2
+RENT 1002 F2 24 48
+RENT 9999 F3 1
+RENT 1002 NOPE 1
+RENT 1002 F3 0
+RENT 1002 F3 2 -5
+QUOTE 24
+QUOTE 5 1
+FREE 0 1
+FREE 48 2
+PLATES
+RENTED
+ALLOCATE 1002 count=1 capacity=7 hours=3
+ALLOCATE 1002 count=2 capacity=7 hours=3
+MOVE F3 north
+MOVE NOPE north
+RETURN F1
+RETURN F1
+RETURN F3
+RENTED
+HELLO
+REGISTER no fields
+EOF2
+stop_server
+echo "--- restart"
+serve || return
+request <<'EOF2'
+RENTED
+FREE 48 2
+QUOTE 1
+EOF2
+stop_server
@@ -0,0 +1,39 @@
+# fleet.snap is only trusted if its version is known and its checksum matches.
+# Otherwise it is kept as fleet.snap.bad, the fleet is loaded from the .txt
+# files, and the journal written against the snapshot is set aside rather than
+# replayed. F4 is taken out of the .txt files to tell the two apart.
+new_store
+sed '/^F4 /d' "car rental.txt" > edited.txt && mv edited.txt "car rental.txt"
+sed '/^F4 /d' available.txt > edited.txt && mv edited.txt available.txt
+echo "--- intact"
+batch <<'EOF'
+search model=Alza
+EOF
+echo "--- one byte of the body changed, with a journal"
+printf 'A J1 Kia Picanto 4 Blue 8 50 90 A\n' >> fleet.journal
+printf 'X' | dd of=fleet.snap bs=1 seek=48 conv=notrunc 2> /dev/null
+cp fleet.snap corrupt.snap
+batch <<'EOF'
+search model=Alza
+search model=Vios
+search model=Picanto
+EOF
+cmp -s fleet.snap.bad corrupt.snap && echo "fleet.snap.bad is the corrupt snapshot"
+cat fleet.journal.bad
+echo "--- unknown older version"
+printf '\000' | dd of=fleet.snap bs=1 seek=8 conv=notrunc 2> /dev/null
+batch <<'EOF'
+search model=Vios
+EOF
+echo "--- newer version"
+printf '\143' | dd of=fleet.snap bs=1 seek=8 conv=notrunc 2> /dev/null
+cp fleet.snap newer.snap
+batch <<'EOF'
+search model=Vios
+EOF
+cmp -s fleet.snap newer.snap && echo "fleet.snap left as it was"
+echo "--- rewritten"
+rm fleet.snap
+batch <<'EOF'
+search model=Vios
+EOF
@@ -0,0 +1,28 @@
+# Compacting the journal drops the strings of deleted cars from the fleet's
+# string pool. Searches, long plates and branches must survive the
+# renumbering, both in the running fleet and in the snapshot it writes.
+new_store
+{
+    echo "add LONGPLATE-000000001 Hyundai Ioniq 5 Grey 20 90 160 A depot"
+    echo "search brand=Toyota"
+    for i in $(seq 2100); do
+        echo "add T$i Brand$i Model$i 5 Colour$i 10 60 100 A"
+        echo "delete T$i"
+    done
+    echo "search brand=Toyota"
+    echo "search brand=hyundai branch=depot"
+    echo "search colour=Colour7"
+    echo "add T7 Brand7 Model7 5 Colour7 10 60 100 A"
+    echo "search colour=Colour7"
+    echo "rent 1001 LONGPLATE-000000001 2"
+    echo "return LONGPLATE-000000001"
+} > ops.txt
+batch < ops.txt | grep -v ': add OK$\|: delete OK$'
+echo "--- restart"
+batch <<'EOF2'
+search brand=Toyota
+search brand=Hyundai branch=depot
+search model=Model7
+move LONGPLATE-000000001 main
+search branch=depot
+EOF2
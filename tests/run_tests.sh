@@ -0,0 +1,92 @@
+#!/bin/bash
+# Runs every tests/cases/<case>.sh in a scratch directory and compares what it
+# prints with tests/cases/<case>.expected. Usage:
+#   tests/run_tests.sh [car_rental_system] [case...]
+# Without a binary main.c is built first; without case names every case runs.
+# Exits with the number of failed cases.
+
+here=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+if [ $# -gt 0 ] && [ -f "$1" ]; then
+    app=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+    shift
+else
+    app=$work/car_rental_system
+    g++ -std=c++17 -O2 -x c++ "$here/../main.c" -o "$app" -pthread || exit 1
+fi
+
+# Runs the batch operations on stdin against the store in the current
+# directory. The timing in the summary line is dropped, and load errors
+# (stderr) follow the results.
+batch() {
+    cat > "$work/batch.txt"
+    "$app" --batch "$work/batch.txt" > "$work/stdout" 2> "$work/stderr"
+    sed 's/ in [0-9.e+-]* s (.*//' "$work/stdout"
+    cat "$work/stderr"
+}
+
+# Starts the current directory over with four cars and one customer (1001),
+# saved in fleet.snap with an empty journal
+new_store() {
+    rm -rf "$work/store" && mkdir "$work/store" && cd "$work/store" || exit 1
+    batch > /dev/null <<'EOF'
+register Ali Tan;0123;IC1;1 Jalan Bukit
+add F1 Toyota Vios 5 White 10 60 100 A
+add F2 Toyota Vios 5 Black 10 60 100 A
+add F3 Honda City 5 Red 12 70 120 M
+add F4 Perodua Alza 7 Silver 15 80 140 A
+EOF
+}
+
+# Starts the server (--serve) on the store in the current directory and waits
+# until it accepts connections. $server is its process ID.
+serve() {
+    port=$((20000 + RANDOM % 20000))
+    "$app" --serve $port 4 > /dev/null 2> "$work/server.err" &
+    server=$!
+    for attempt in $(seq 50); do
+        (exec 3<> "/dev/tcp/127.0.0.1/$port") 2> /dev/null && return 0
+        sleep 0.1
+    done
+    echo "the server did not start"
+    return 1
+}
+
+# Sends the requests on stdin over one connection and prints each with its reply
+request() {
+    exec 3<> "/dev/tcp/127.0.0.1/$port"
+    while IFS= read -r line; do
+        echo "$line" >&3
+        IFS= read -r reply <&3
+        echo "$line -> $reply"
+    done
+    exec 3>&-
+}
+
+# Stops the server with SHUTDOWN and prints what it wrote to stderr
+stop_server() {
+    echo SHUTDOWN | request > /dev/null
+    wait $server
+    cat "$work/server.err"
+}
+
+if [ $# -gt 0 ]; then
+    cases=("$@")
+else
+    cases=()
+    for file in "$here"/cases/*.sh; do cases+=("$(basename "$file" .sh)"); done
+fi
+
+failed=0
+for name in "${cases[@]}"; do
+    (cd "$work" && . "$here/cases/$name.sh") > "$work/$name.out" 2>&1
+    if diff -u "$here/cases/$name.expected" "$work/$name.out"; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name"
+        failed=$((failed + 1))
+    fi
+done
+exit $failed